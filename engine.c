@@ -11,6 +11,22 @@
 
 #ifdef _WIN32
     #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// SIMD para los núcleos de mezcla: se usa el mejor conjunto disponible en compilación
+// (AVX2 con -mavx2 / -march=native; SSE2 siempre en x86-64). Sin SIMD queda el camino escalar.
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define GE_SIMD_AVX2 1
+    #define GE_SIMD_SSE2 1 // AVX2 incluye SSE2 (núcleos de 128 bits)
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define GE_SIMD_SSE2 1
 #endif
 
 #include "fenster.h" 
@@ -29,6 +45,87 @@
 // ESTRUCTURAS
 // ============================================================================
 
+// Pasada diferida de sprites (GE_BeginDeferredSprites / GE_EndDeferredSprites)
+typedef struct {
+    GE_Sprite* sprite;
+    int src_x, src_y, src_w, src_h;
+    int dest_x, dest_y, dest_w, dest_h;
+    int flip;
+    GE_Color tint;
+    GE_BlendMode mode;       // Estado activo al grabar el dibujo
+    GE_TextureFilter filter;
+    int x0, y0, x1, y1;      // Rect destino ya recortado a la pantalla
+} GE_DeferredCmd;
+
+// Tramo [x0, x1) de una fila del c-buffer tapado por el comando opaco 'index'
+typedef struct { int x0, x1, index; } GE_CoverSpan;
+
+typedef struct {
+    bool recording;
+    uint64_t pass_id;        // Aumenta en cada Begin (las cachés fijan lo grabado en esta pasada)
+    GE_DeferredCmd* cmds;
+    int count, capacity;
+    GE_CoverSpan** rows;     // c-buffer: tramos cubiertos de cada fila, ordenados por x
+    int* row_count;
+    int* row_capacity;
+    int row_total;
+    GE_CoverSpan* scratch;   // Tramos a pintar de la fila en curso
+    int scratch_capacity;
+    GE_DeferredStats stats;  // Del último GE_EndDeferredSprites
+    GE_Sprite** retired;     // Imágenes de caché soltadas con dibujos aún grabados: se liberan al terminar
+    int retired_count, retired_capacity;
+} GE_DeferredPass;
+
+// Capa con buffer propio (GE_CreateLayer). Las transparentes guardan ARGB premultiplicado.
+struct GE_Layer {
+    GE_Context* ctx;         // NULL si el contexto ya se cerró
+    uint32_t* pixels;
+    int width, height;
+    int z;                   // Orden de composición (menor = más al fondo)
+    int scroll_x, scroll_y;  // Desplazamiento cíclico al componer
+    bool opaque;
+    bool dirty;
+    bool visible;
+    GE_BlendMode blend;      // ALPHA u ADDITIVE al componer
+};
+
+// Render multihilo por tiles (GE_EnableThreadedRendering)
+#define GE_RENDER_TILE 64
+
+enum { GE_RCMD_SPAN = 0, GE_RCMD_FILL, GE_RCMD_SPRITE };
+
+// Comando grabado (24 bytes). Los sprites guardan su descripción completa aparte.
+typedef struct {
+    uint32_t* target;        // Buffer destino al grabar (lienzo o capa)
+    GE_Color color;          // SPAN / FILL
+    int32_t y;               // SPAN: fila | SPRITE: índice en 'sprites'
+    int16_t x0, x1;          // SPAN: tramo [x0, x1] inclusive
+    uint8_t type, mode;
+} GE_RenderCmd;
+
+typedef struct {
+    struct GE_RenderQueue* queue;
+    GE_Context* local;       // Contexto mínimo propio (buffer, recorte, modo) para los blitters
+    ma_thread thread;
+} GE_RenderWorker;
+
+typedef struct GE_RenderQueue {
+    GE_RenderCmd* cmds;
+    int count, capacity;
+    GE_DeferredCmd* sprites; // x0..y1 = zona donde puede escribir
+    int sprite_count, sprite_capacity;
+    uint32_t** bins;         // Índices de comando de cada tile, en orden de envío
+    int* bin_count;
+    int* bin_capacity;
+    int tiles_x, tiles_y;
+    GE_RenderWorker* workers; // Hilos auxiliares: el principal también rasteriza
+    int worker_count;
+    GE_Context* main_local;
+    ma_semaphore start, done;
+    volatile ma_uint32 next_tile;
+    volatile bool quit;
+} GE_RenderQueue;
+
 struct GE_Context {
     struct fenster f; 
     uint32_t* render_buffer; // Tu lienzo de baja resolución (320x240)
@@ -40,8 +137,150 @@ struct GE_Context {
     double last_time;
     float delta_time;
     int target_fps;
+
+    // Buffer temporal reutilizable para GE_DrawSpriteBatch (culling + orden)
+    uint64_t* batch_keys;
+    int batch_capacity;
+
+    // Modo de mezcla activo (primitivas, sprites y texto)
+    GE_BlendMode blend_mode;
+
+    // Filtro de muestreo para sprites escalados / rotados
+    GE_TextureFilter texture_filter;
+
+    // Caché opcional de sprites pretransformados (NULL = desactivada)
+    struct GE_TransformCache* xform_cache;
+
+    // Pasada diferida (se crea en el primer GE_BeginDeferredSprites)
+    GE_DeferredPass* deferred;
+
+    // Recorte de los blitters de sprites: la pasada diferida lo reduce a tramos visibles
+    bool clip_enabled;
+    int clip_x0, clip_y0, clip_x1, clip_y1;
+
+    // Capas ordenadas por z. Entre GE_BeginLayer y GE_EndLayer, render_buffer apunta
+    // a la capa activa y screen_buffer guarda el lienzo real.
+    GE_Layer** layers;
+    int layer_count, layer_capacity;
+    GE_Layer* active_layer;
+    uint32_t* screen_buffer;
+    bool layers_composed;    // Ya compuestas este frame (GE_PollEvents no repite)
+
+    // Render multihilo: los dibujos se graban y se rasterizan por tiles (NULL = inmediato)
+    GE_RenderQueue* render_queue;
 };
 
+// Frames presentados por GE_PollEvents: reloj de las cachés que caducan por frames
+static uint32_t g_frame_index = 0;
+
+// --- RENDER MULTIHILO: GRABACIÓN ---
+// Con GE_EnableThreadedRendering los dibujos no tocan el buffer: se guardan como
+// comandos compactos y cada uno se apunta en los tiles de GE_RENDER_TILE px que toca.
+// GE_FlushRendering (lo llama GE_PollEvents) reparte los tiles entre los hilos; cada
+// tile ejecuta sus comandos en el orden de envío, así el resultado es el mismo que en
+// modo inmediato. Si falta memoria para grabar se vacía la cola y quien llama dibuja
+// al momento (retornan false), sin alterar el orden.
+
+// Apunta el comando 'index' en los tiles de [x0, x1) x [y0, y1) (ya dentro del lienzo).
+// Primero reserva en todos para no dejar un comando a medio repartir.
+static bool GE_BinRenderCmd(GE_RenderQueue* q, int index, int x0, int y0, int x1, int y1) {
+    int tx0 = x0 / GE_RENDER_TILE, tx1 = (x1 - 1) / GE_RENDER_TILE;
+    int ty0 = y0 / GE_RENDER_TILE, ty1 = (y1 - 1) / GE_RENDER_TILE;
+    for (int ty = ty0; ty <= ty1; ty++) {
+        for (int tx = tx0; tx <= tx1; tx++) {
+            int t = ty * q->tiles_x + tx;
+            if (q->bin_count[t] < q->bin_capacity[t]) continue;
+            int new_cap = q->bin_capacity[t] ? q->bin_capacity[t] * 2 : 64;
+            uint32_t* bin = (uint32_t*)realloc(q->bins[t], new_cap * sizeof(uint32_t));
+            if (!bin) return false;
+            q->bins[t] = bin;
+            q->bin_capacity[t] = new_cap;
+        }
+    }
+    for (int ty = ty0; ty <= ty1; ty++) {
+        for (int tx = tx0; tx <= tx1; tx++) {
+            int t = ty * q->tiles_x + tx;
+            q->bins[t][q->bin_count[t]++] = (uint32_t)index;
+        }
+    }
+    return true;
+}
+
+// Reserva un comando al final de la cola (NULL si no hay memoria)
+static GE_RenderCmd* GE_PushRenderCmd(GE_RenderQueue* q) {
+    if (q->count == q->capacity) {
+        int new_cap = q->capacity ? q->capacity * 2 : 1024;
+        GE_RenderCmd* cmds = (GE_RenderCmd*)realloc(q->cmds, new_cap * sizeof(GE_RenderCmd));
+        if (!cmds) return NULL;
+        q->cmds = cmds;
+        q->capacity = new_cap;
+    }
+    return &q->cmds[q->count];
+}
+
+// Tramo [x0, x1] de la fila y, ya recortado al lienzo, con el modo activo
+static bool GE_RecordSpan(GE_Context* ctx, int x0, int x1, int y, GE_Color color) {
+    if ((color >> 24) == 0) return true; // Transparente: no pinta nada
+    GE_RenderQueue* q = ctx->render_queue;
+    GE_RenderCmd* cmd = GE_PushRenderCmd(q);
+    if (!cmd || !GE_BinRenderCmd(q, q->count, x0, y, x1 + 1, y + 1)) {
+        GE_FlushRendering(ctx);
+        return false;
+    }
+    cmd->target = ctx->render_buffer;
+    cmd->color = color;
+    cmd->y = y;
+    cmd->x0 = (int16_t)x0;
+    cmd->x1 = (int16_t)x1;
+    cmd->type = GE_RCMD_SPAN;
+    cmd->mode = (uint8_t)ctx->blend_mode;
+    q->count++;
+    return true;
+}
+
+// Relleno completo del buffer activo (GE_Clear)
+static bool GE_RecordFill(GE_Context* ctx, GE_Color color) {
+    GE_RenderQueue* q = ctx->render_queue;
+    GE_RenderCmd* cmd = GE_PushRenderCmd(q);
+    if (!cmd || !GE_BinRenderCmd(q, q->count, 0, 0, ctx->render_width, ctx->render_height)) {
+        GE_FlushRendering(ctx);
+        return false;
+    }
+    memset(cmd, 0, sizeof(*cmd));
+    cmd->target = ctx->render_buffer;
+    cmd->color = color;
+    cmd->type = GE_RCMD_FILL;
+    q->count++;
+    return true;
+}
+
+// Sprite alineado a ejes: solo escribe dentro de cmd->x0..y1
+static bool GE_RecordSprite(GE_Context* ctx, const GE_DeferredCmd* sprite) {
+    GE_RenderQueue* q = ctx->render_queue;
+    if (q->sprite_count == q->sprite_capacity) {
+        int new_cap = q->sprite_capacity ? q->sprite_capacity * 2 : 256;
+        GE_DeferredCmd* list = (GE_DeferredCmd*)realloc(q->sprites, new_cap * sizeof(GE_DeferredCmd));
+        if (!list) {
+            GE_FlushRendering(ctx);
+            return false;
+        }
+        q->sprites = list;
+        q->sprite_capacity = new_cap;
+    }
+    GE_RenderCmd* cmd = GE_PushRenderCmd(q);
+    if (!cmd || !GE_BinRenderCmd(q, q->count, sprite->x0, sprite->y0, sprite->x1, sprite->y1)) {
+        GE_FlushRendering(ctx);
+        return false;
+    }
+    memset(cmd, 0, sizeof(*cmd));
+    cmd->target = ctx->render_buffer;
+    cmd->y = q->sprite_count;
+    cmd->type = GE_RCMD_SPRITE;
+    q->sprites[q->sprite_count++] = *sprite;
+    q->count++;
+    return true;
+}
+
 // ============================================================================
 // CORE (Init, Close, Poll, Clear)
 // ============================================================================
@@ -53,6 +292,9 @@ static void GE_UpdateWindowBuffer(GE_Context* ctx) {
     ctx->f.buf = (uint32_t*)calloc(ctx->f.width * ctx->f.height, sizeof(uint32_t));
 }
 
+static void GE_ShutdownFontWorker(void); // Hilo de carga de fuentes (sección de texto)
+static void GE_FreeCachedImage(GE_Sprite* image); // Caché de transformaciones
+
 GE_Context* GE_Init(const char* title, int game_width, int game_height) {
     GE_Context* ctx = (GE_Context*)calloc(1, sizeof(GE_Context));
     if (!ctx) return NULL;
@@ -99,8 +341,26 @@ GE_Context* GE_Init(const char* title, int game_width, int game_height) {
 void GE_Close(GE_Context* ctx) {
     if (ctx) {
         fenster_close(&ctx->f);
+        GE_EnableThreadedRendering(ctx, 0);
+        GE_ShutdownFontWorker();
+        if (ctx->active_layer) ctx->render_buffer = ctx->screen_buffer;
+        for (int i = 0; i < ctx->layer_count; i++) ctx->layers[i]->ctx = NULL; // Las libera GE_UnloadLayer
+        free(ctx->layers);
         if (ctx->f.buf) free(ctx->f.buf);
         if (ctx->render_buffer) free(ctx->render_buffer);
+        if (ctx->batch_keys) free(ctx->batch_keys);
+        GE_EnableTransformCache(ctx, 0);
+        if (ctx->deferred) {
+            for (int y = 0; y < ctx->deferred->row_total; y++) free(ctx->deferred->rows[y]);
+            free(ctx->deferred->rows);
+            free(ctx->deferred->row_count);
+            free(ctx->deferred->row_capacity);
+            free(ctx->deferred->scratch);
+            free(ctx->deferred->cmds);
+            for (int i = 0; i < ctx->deferred->retired_count; i++) GE_FreeCachedImage(ctx->deferred->retired[i]);
+            free(ctx->deferred->retired);
+            free(ctx->deferred);
+        }
         free(ctx);
     }
 }
@@ -114,6 +374,13 @@ bool GE_PollEvents(GE_Context* ctx) {
     ctx->delta_time = (float)(now - ctx->last_time) / 1000.0f;
     ctx->last_time = now;
 
+    g_frame_index++;
+
+    // Dibujos grabados (render multihilo) y capas encima del lienzo
+    GE_FlushRendering(ctx);
+    if (ctx->layer_count > 0 && !ctx->layers_composed) GE_ComposeLayers(ctx);
+    ctx->layers_composed = false;
+
     // 2. ESCALADO (De Render Buffer -> Ventana)
     // Calculamos escala para mantener proporción (Letterboxing)
     float scale_x = (float)ctx->f.width / ctx->render_width;
@@ -169,6 +436,7 @@ bool GE_PollEvents(GE_Context* ctx) {
 
 void GE_Clear(GE_Context* ctx, GE_Color color) {
     if (!ctx || !ctx->render_buffer) return;
+    if (ctx->render_queue && GE_RecordFill(ctx, color)) return;
     int count = ctx->render_width * ctx->render_height;
     for (int i = 0; i < count; i++) ctx->render_buffer[i] = color;
 }
@@ -252,15 +520,426 @@ void GE_ShowCursor(bool visible) {
     #endif
 }
 
+// ============================================================================
+// MODOS DE MEZCLA (BLEND) - Compartidos por primitivas, sprites y texto
+// ============================================================================
+// S = color fuente, A = su alpha, D = destino (en 0..1). La pantalla siempre queda opaca.
+//   ALPHA:    D = S*A + D*(1-A)
+//   ADDITIVE: D = D + S*A               (saturado; brillos, fuego, partículas)
+//   MULTIPLY: D = D * (S*A + 1 - A)     (sombras, oscurecer la escena)
+//   SCREEN:   D = 1 - (1-D) * (1-S*A)   (aclarar sin quemar)
+//   REPLACE:  D = S                     (copia directa; alpha 0 se sigue saltando)
+// Con alpha premultiplicado S*A ya viene hecho en el texel.
+
+#define GE_BLEND_MODE_COUNT 5
+
+void GE_SetBlendMode(GE_Context* ctx, GE_BlendMode mode) {
+    if (!ctx) return;
+    if ((unsigned)mode >= GE_BLEND_MODE_COUNT) mode = GE_BLEND_ALPHA;
+    ctx->blend_mode = mode;
+}
+
+GE_BlendMode GE_GetBlendMode(GE_Context* ctx) {
+    return ctx ? ctx->blend_mode : GE_BLEND_ALPHA;
+}
+
+// --- Helper para mezclar colores (Alpha Blending) ---
+// Mezcla un color nuevo (fg) sobre el color existente (bg) respetando la transparencia
+static GE_Color GE_BlendColors(GE_Color bg, GE_Color fg, uint8_t alpha_sprite) {
+    // Si el sprite es totalmente transparente, no hacemos nada
+    if (alpha_sprite == 0) return bg;
+
+    // Extraer componentes del Fondo (Background)
+    uint8_t bg_a = (bg >> 24) & 0xFF;
+    uint8_t bg_r = (bg >> 16) & 0xFF;
+    uint8_t bg_g = (bg >> 8)  & 0xFF;
+    uint8_t bg_b = bg & 0xFF;
+
+    // Extraer componentes del Frente (Foreground/Sprite)
+    uint8_t fg_a = (fg >> 24) & 0xFF;
+    uint8_t fg_r = (fg >> 16) & 0xFF;
+    uint8_t fg_g = (fg >> 8)  & 0xFF;
+    uint8_t fg_b = fg & 0xFF;
+
+    // Combinar el alpha del píxel con el alpha global (si quisiéramos tintes semitransparentes)
+    // Por ahora usamos el alpha del píxel directo.
+
+    // Fórmula estándar de Alpha Blending:
+    // Out = (Alpha * Fg + (255 - Alpha) * Bg) / 255
+    uint16_t alpha = alpha_sprite;
+    uint16_t inv_alpha = 255 - alpha;
+
+    uint8_t out_r = (uint8_t)((alpha * fg_r + inv_alpha * bg_r) / 255);
+    uint8_t out_g = (uint8_t)((alpha * fg_g + inv_alpha * bg_g) / 255);
+    uint8_t out_b = (uint8_t)((alpha * fg_b + inv_alpha * bg_b) / 255);
+    // Cobertura acumulada: sobre un destino opaco sigue siendo 255; en una capa
+    // transparente (GE_Layer) conserva cuánto cubre lo dibujado
+    uint8_t out_a = (uint8_t)(alpha + (inv_alpha * bg_a) / 255);
+
+    return (out_a << 24) | (out_r << 16) | (out_g << 8) | out_b;
+}
+
+// --- Operaciones escalares por píxel ---
+// (d = puntero destino, r/g/b/a = componentes fuente ya tintados, variables locales)
+
+// Fuente opaca o REPLACE: escritura directa
+#define GE_STORE_OPAQUE(d, r, g, b, a) \
+    (*(d) = 0xFF000000u | ((r) << 16) | ((g) << 8) | (b))
+
+// Alpha normal: mismo resultado exacto que GE_BlendColors. El alpha del destino
+// acumula cobertura (A + Da*(1-A)), así que el color queda premultiplicado cuando
+// el destino es una capa transparente; sobre el buffer opaco no cambia nada.
+#define GE_STORE_ALPHA(d, r, g, b, a) do { \
+    if ((a) == 255) { GE_STORE_OPAQUE(d, r, g, b, a); break; } \
+    uint32_t bg_ = *(d), ia_ = 255 - (a); \
+    uint32_t r_ = ((a) * (r) + ia_ * ((bg_ >> 16) & 0xFF)) / 255; \
+    uint32_t g_ = ((a) * (g) + ia_ * ((bg_ >> 8) & 0xFF)) / 255; \
+    uint32_t b_ = ((a) * (b) + ia_ * (bg_ & 0xFF)) / 255; \
+    uint32_t a_ = (a) + (ia_ * (bg_ >> 24)) / 255; \
+    *(d) = (a_ << 24) | (r_ << 16) | (g_ << 8) | b_; \
+} while (0)
+
+// Alpha premultiplicado: Out = Src + Dst * (255 - A) / 255
+#define GE_STORE_PREMUL(d, r, g, b, a) do { \
+    if ((a) == 255) { GE_STORE_OPAQUE(d, r, g, b, a); break; } \
+    uint32_t bg_ = *(d), ia_ = 255 - (a); \
+    uint32_t r_ = (r) + (ia_ * ((bg_ >> 16) & 0xFF)) / 255; \
+    uint32_t g_ = (g) + (ia_ * ((bg_ >> 8) & 0xFF)) / 255; \
+    uint32_t b_ = (b) + (ia_ * (bg_ & 0xFF)) / 255; \
+    if (r_ > 255) r_ = 255; \
+    if (g_ > 255) g_ = 255; \
+    if (b_ > 255) b_ = 255; \
+    uint32_t a_ = (a) + (ia_ * (bg_ >> 24)) / 255; \
+    *(d) = (a_ << 24) | (r_ << 16) | (g_ << 8) | b_; \
+} while (0)
+
+// Los demás modos trabajan con la fuente premultiplicada (S*A)
+#define GE_PREMUL_RGB(r, g, b, a) do { r = (r * (a)) / 255; g = (g * (a)) / 255; b = (b * (a)) / 255; } while (0)
+
+// REPLACE con fuente premultiplicada: se deshace S*A para escribir lo mismo que la recta
+#define GE_STORE_UNPREMUL(d, r, g, b, a) do { \
+    if ((a) < 255) { \
+        r = (r * 255 + (a) / 2) / (a); \
+        g = (g * 255 + (a) / 2) / (a); \
+        b = (b * 255 + (a) / 2) / (a); \
+        if (r > 255) r = 255; \
+        if (g > 255) g = 255; \
+        if (b > 255) b = 255; \
+    } \
+    GE_STORE_OPAQUE(d, r, g, b, a); \
+} while (0)
+
+#define GE_OP_ADD(d, r, g, b, a) do { \
+    uint32_t bg_ = *(d); \
+    uint32_t r_ = ((bg_ >> 16) & 0xFF) + (r); \
+    uint32_t g_ = ((bg_ >> 8) & 0xFF) + (g); \
+    uint32_t b_ = (bg_ & 0xFF) + (b); \
+    if (r_ > 255) r_ = 255; \
+    if (g_ > 255) g_ = 255; \
+    if (b_ > 255) b_ = 255; \
+    *(d) = 0xFF000000u | (r_ << 16) | (g_ << 8) | b_; \
+} while (0)
+
+#define GE_OP_MULTIPLY(d, r, g, b, a) do { \
+    uint32_t bg_ = *(d), ia_ = 255 - (a); \
+    uint32_t fr_ = (r) + ia_, fg_ = (g) + ia_, fb_ = (b) + ia_; \
+    if (fr_ > 255) fr_ = 255; \
+    if (fg_ > 255) fg_ = 255; \
+    if (fb_ > 255) fb_ = 255; \
+    uint32_t r_ = (((bg_ >> 16) & 0xFF) * fr_) / 255; \
+    uint32_t g_ = (((bg_ >> 8) & 0xFF) * fg_) / 255; \
+    uint32_t b_ = ((bg_ & 0xFF) * fb_) / 255; \
+    *(d) = 0xFF000000u | (r_ << 16) | (g_ << 8) | b_; \
+} while (0)
+
+#define GE_OP_SCREEN(d, r, g, b, a) do { \
+    uint32_t bg_ = *(d); \
+    uint32_t br_ = (bg_ >> 16) & 0xFF, bgg_ = (bg_ >> 8) & 0xFF, bb_ = bg_ & 0xFF; \
+    uint32_t r_ = br_ + ((r) * (255 - br_)) / 255; \
+    uint32_t g_ = bgg_ + ((g) * (255 - bgg_)) / 255; \
+    uint32_t b_ = bb_ + ((b) * (255 - bb_)) / 255; \
+    *(d) = 0xFF000000u | (r_ << 16) | (g_ << 8) | b_; \
+} while (0)
+
+// Variantes para fuente recta (sin premultiplicar)
+#define GE_STORE_ADD(d, r, g, b, a)      do { GE_PREMUL_RGB(r, g, b, a); GE_OP_ADD(d, r, g, b, a); } while (0)
+#define GE_STORE_MULTIPLY(d, r, g, b, a) do { GE_PREMUL_RGB(r, g, b, a); GE_OP_MULTIPLY(d, r, g, b, a); } while (0)
+#define GE_STORE_SCREEN(d, r, g, b, a)   do { GE_PREMUL_RGB(r, g, b, a); GE_OP_SCREEN(d, r, g, b, a); } while (0)
+
+// Mezcla un color sólido (0xAARRGGBB, alpha recto) sobre un píxel
+static inline void GE_BlendPixel(uint32_t* dst, GE_Color color, GE_BlendMode mode) {
+    uint32_t a = color >> 24;
+    if (a == 0) return; // Transparente
+    uint32_t r = (color >> 16) & 0xFF, g = (color >> 8) & 0xFF, b = color & 0xFF;
+    switch (mode) {
+        case GE_BLEND_ADDITIVE: GE_STORE_ADD(dst, r, g, b, a); break;
+        case GE_BLEND_MULTIPLY: GE_STORE_MULTIPLY(dst, r, g, b, a); break;
+        case GE_BLEND_SCREEN:   GE_STORE_SCREEN(dst, r, g, b, a); break;
+        case GE_BLEND_REPLACE:  GE_STORE_OPAQUE(dst, r, g, b, a); break;
+        default:                *dst = GE_BlendColors(*dst, color, (uint8_t)a); break;
+    }
+}
+
+// Tinte ya desempaquetado: se extrae una vez por llamada (o por lote), no por píxel
+typedef struct {
+    GE_Color color;
+    uint8_t r, g, b;
+} GE_Tint;
+
+static inline GE_Tint GE_MakeTint(GE_Color color) {
+    GE_Tint t = { color, (color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF };
+    return t;
+}
+
+// --- NÚCLEOS SIMD ---
+// Mismas fórmulas que las macros escalares, con resultados idénticos bit a bit:
+// cada canal se expande a 16 bits y la división entre 255 es exacta con
+// (x + 1 + (x >> 8)) >> 8 (válido para x <= 255*255). SSE2 procesa 4 píxeles por
+// iteración y AVX2 8; el resto del span lo termina el camino escalar.
+#ifdef GE_SIMD_SSE2
+
+#if defined(GE_SIMD_AVX2)
+    typedef __m256i GE_Vec;
+    #define GE_SIMD_LANES 8
+    #define GE_V_ZERO()          _mm256_setzero_si256()
+    #define GE_V_SET16(x)        _mm256_set1_epi16((short)(x))
+    #define GE_V_SET32(x)        _mm256_set1_epi32((int)(x))
+    #define GE_V_SET64(x)        _mm256_set1_epi64x((long long)(x))
+    #define GE_V_LOAD(p)         _mm256_loadu_si256((const __m256i*)(const void*)(p))
+    #define GE_V_STORE(p, v)     _mm256_storeu_si256((__m256i*)(void*)(p), v)
+    #define GE_V_UNPACKLO8(a, b) _mm256_unpacklo_epi8(a, b)
+    #define GE_V_UNPACKHI8(a, b) _mm256_unpackhi_epi8(a, b)
+    #define GE_V_PACKUS16(a, b)  _mm256_packus_epi16(a, b)
+    #define GE_V_ADD16(a, b)     _mm256_add_epi16(a, b)
+    #define GE_V_SUB16(a, b)     _mm256_sub_epi16(a, b)
+    #define GE_V_MUL16(a, b)     _mm256_mullo_epi16(a, b)
+    #define GE_V_MIN16(a, b)     _mm256_min_epi16(a, b)
+    #define GE_V_SRL16(a, n)     _mm256_srli_epi16(a, n)
+    #define GE_V_CMPEQ32(a, b)   _mm256_cmpeq_epi32(a, b)
+    #define GE_V_AND(a, b)       _mm256_and_si256(a, b)
+    #define GE_V_ANDNOT(a, b)    _mm256_andnot_si256(a, b)
+    #define GE_V_OR(a, b)        _mm256_or_si256(a, b)
+    #define GE_V_SHUF16(a, imm)  _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(a, imm), imm)
+    #define GE_V_MOVEMASK8(a)    _mm256_movemask_epi8(a)
+    #define GE_V_MASK_ALL        (-1)
+    // 8 bytes de cobertura -> byte alto de cada carril de 32 bits
+    #define GE_V_LOAD_A8(p)      _mm256_slli_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(const void*)(p))), 24)
+#else
+    typedef __m128i GE_Vec;
+    #define GE_SIMD_LANES 4
+    #define GE_V_ZERO()          _mm_setzero_si128()
+    #define GE_V_SET16(x)        _mm_set1_epi16((short)(x))
+    #define GE_V_SET32(x)        _mm_set1_epi32((int)(x))
+    #define GE_V_SET64(x)        _mm_set1_epi64x((long long)(x))
+    #define GE_V_LOAD(p)         _mm_loadu_si128((const __m128i*)(const void*)(p))
+    #define GE_V_STORE(p, v)     _mm_storeu_si128((__m128i*)(void*)(p), v)
+    #define GE_V_UNPACKLO8(a, b) _mm_unpacklo_epi8(a, b)
+    #define GE_V_UNPACKHI8(a, b) _mm_unpackhi_epi8(a, b)
+    #define GE_V_PACKUS16(a, b)  _mm_packus_epi16(a, b)
+    #define GE_V_ADD16(a, b)     _mm_add_epi16(a, b)
+    #define GE_V_SUB16(a, b)     _mm_sub_epi16(a, b)
+    #define GE_V_MUL16(a, b)     _mm_mullo_epi16(a, b)
+    #define GE_V_MIN16(a, b)     _mm_min_epi16(a, b)
+    #define GE_V_SRL16(a, n)     _mm_srli_epi16(a, n)
+    #define GE_V_CMPEQ32(a, b)   _mm_cmpeq_epi32(a, b)
+    #define GE_V_AND(a, b)       _mm_and_si128(a, b)
+    #define GE_V_ANDNOT(a, b)    _mm_andnot_si128(a, b)
+    #define GE_V_OR(a, b)        _mm_or_si128(a, b)
+    #define GE_V_SHUF16(a, imm)  _mm_shufflehi_epi16(_mm_shufflelo_epi16(a, imm), imm)
+    #define GE_V_MOVEMASK8(a)    _mm_movemask_epi8(a)
+    #define GE_V_MASK_ALL        0xFFFF
+    static inline __m128i GE_V_LOAD_A8(const unsigned char* p) {
+        int32_t v;
+        memcpy(&v, p, 4);
+        __m128i x = _mm_unpacklo_epi8(_mm_setzero_si128(), _mm_cvtsi32_si128(v));
+        return _mm_unpacklo_epi16(_mm_setzero_si128(), x);
+    }
+#endif
+
+// x / 255 exacto para x <= 65025 (canales de 16 bits)
+#define GE_V_DIV255(x) GE_V_SRL16(GE_V_ADD16(GE_V_ADD16(x, GE_V_SET16(1)), GE_V_SRL16(x, 8)), 8)
+
+// Mezcla media fila de píxeles ya expandidos a 16 bits (orden B,G,R,A como el destino).
+// MODE y PREMUL son constantes: cada núcleo generado conserva solo su rama.
+// Los texels con alpha 0 los descarta quien llama (máscara de 32 bits).
+#define GE_V_BLEND(MODE, PREMUL, s, d, out) do { \
+    const GE_Vec c255_ = GE_V_SET16(255); \
+    GE_Vec a_ = GE_V_SHUF16(s, 0xFF); \
+    GE_Vec ia_ = GE_V_SUB16(c255_, a_); \
+    if ((MODE) == GE_BLEND_REPLACE) { \
+        out = s; \
+    } else if ((MODE) == GE_BLEND_ALPHA && !(PREMUL)) { \
+        /* En el carril de alpha el factor es 255: Out.a = A + Da*(1-A) */ \
+        GE_Vec m_ = GE_V_OR(GE_V_AND(a_, GE_V_SET64(0x0000FFFFFFFFFFFFull)), \
+                            GE_V_SET64(0x00FF000000000000ull)); \
+        out = GE_V_DIV255(GE_V_ADD16(GE_V_MUL16(s, m_), GE_V_MUL16(d, ia_))); \
+    } else if ((MODE) == GE_BLEND_ALPHA) { \
+        out = GE_V_ADD16(s, GE_V_DIV255(GE_V_MUL16(d, ia_))); \
+    } else { \
+        GE_Vec sp_ = (PREMUL) ? s : GE_V_DIV255(GE_V_MUL16(s, a_)); \
+        if ((MODE) == GE_BLEND_ADDITIVE) { \
+            out = GE_V_ADD16(d, sp_); \
+        } else if ((MODE) == GE_BLEND_MULTIPLY) { \
+            GE_Vec f_ = GE_V_MIN16(GE_V_ADD16(sp_, ia_), c255_); \
+            out = GE_V_DIV255(GE_V_MUL16(d, f_)); \
+        } else { \
+            out = GE_V_ADD16(d, GE_V_DIV255(GE_V_MUL16(sp_, GE_V_SUB16(c255_, d)))); \
+        } \
+    } \
+} while (0)
+
+// Span de sprite sin escalar ni espejo: 'src' son texels RGBA contiguos.
+// Retorna cuántos píxeles procesó (múltiplo de GE_SIMD_LANES).
+typedef int (*GE_SimdSpanFn)(uint32_t* dst, int count, const unsigned char* src, const GE_Tint* tint);
+
+// R,G,B,A (memoria RGBA) -> B,G,R,A (orden de bytes de 0xAARRGGBB)
+#define GE_V_SWAP_RB(v) GE_V_SHUF16(v, 0xC6)
+
+#define GE_DEFINE_SIMD_SPAN(NAME, MODE, PREMUL, TINT) \
+static int NAME(uint32_t* dst, int count, const unsigned char* src, const GE_Tint* tint) { \
+    if ((MODE) == GE_BLEND_REPLACE && (PREMUL)) return 0; /* Deshacer S*A divide: span escalar */ \
+    const GE_Vec zero = GE_V_ZERO(); \
+    const GE_Vec alpha_mask = GE_V_SET32(0xFF000000u); \
+    const GE_Vec tint_v = GE_V_SET64(((uint64_t)255 << 48) | ((uint64_t)tint->r << 32) | \
+                                     ((uint64_t)tint->g << 16) | (uint64_t)tint->b); \
+    (void)tint_v; \
+    int n = count & ~(GE_SIMD_LANES - 1); \
+    for (int i = 0; i < n; i += GE_SIMD_LANES) { \
+        GE_Vec sv = GE_V_LOAD(src + i * 4); \
+        GE_Vec dv = GE_V_LOAD(dst + i); \
+        GE_Vec slo = GE_V_SWAP_RB(GE_V_UNPACKLO8(sv, zero)); \
+        GE_Vec shi = GE_V_SWAP_RB(GE_V_UNPACKHI8(sv, zero)); \
+        if (TINT) { \
+            slo = GE_V_DIV255(GE_V_MUL16(slo, tint_v)); \
+            shi = GE_V_DIV255(GE_V_MUL16(shi, tint_v)); \
+        } \
+        GE_Vec dlo = GE_V_UNPACKLO8(dv, zero), dhi = GE_V_UNPACKHI8(dv, zero), rlo, rhi; \
+        GE_V_BLEND(MODE, PREMUL, slo, dlo, rlo); \
+        GE_V_BLEND(MODE, PREMUL, shi, dhi, rhi); \
+        /* Texels con alpha 0 dejan el destino intacto (igual que el escalar) */ \
+        GE_Vec skip = GE_V_CMPEQ32(GE_V_AND(sv, alpha_mask), zero); \
+        GE_Vec res = GE_V_PACKUS16(rlo, rhi); \
+        if ((MODE) != GE_BLEND_ALPHA) res = GE_V_OR(res, alpha_mask); \
+        GE_V_STORE(dst + i, GE_V_OR(GE_V_AND(skip, dv), GE_V_ANDNOT(skip, res))); \
+    } \
+    return n; \
+}
+
+// Span de color sólido (primitivas). Retorna cuántos píxeles procesó.
+typedef int (*GE_SimdSolidFn)(uint32_t* dst, int count, GE_Color color);
+
+#define GE_DEFINE_SIMD_SOLID(NAME, MODE) \
+static int NAME(uint32_t* dst, int count, GE_Color color) { \
+    const GE_Vec zero = GE_V_ZERO(); \
+    const GE_Vec alpha_mask = GE_V_SET32(0xFF000000u); \
+    const GE_Vec s = GE_V_UNPACKLO8(GE_V_SET32(color), zero); \
+    int n = count & ~(GE_SIMD_LANES - 1); \
+    for (int i = 0; i < n; i += GE_SIMD_LANES) { \
+        GE_Vec dv = GE_V_LOAD(dst + i); \
+        GE_Vec dlo = GE_V_UNPACKLO8(dv, zero), dhi = GE_V_UNPACKHI8(dv, zero), rlo, rhi; \
+        GE_V_BLEND(MODE, 0, s, dlo, rlo); \
+        GE_V_BLEND(MODE, 0, s, dhi, rhi); \
+        GE_Vec res = GE_V_PACKUS16(rlo, rhi); \
+        if ((MODE) != GE_BLEND_ALPHA) res = GE_V_OR(res, alpha_mask); \
+        GE_V_STORE(dst + i, res); \
+    } \
+    return n; \
+}
+
+// Span de cobertura A8 (texto): cada texel es el alpha y el color es el del tinte.
+// 'src' son bytes de cobertura contiguos; el texel se arma ya en orden 0xAARRGGBB.
+#define GE_DEFINE_SIMD_COVERAGE(NAME, MODE) \
+static int NAME(uint32_t* dst, int count, const unsigned char* src, const GE_Tint* tint) { \
+    const GE_Vec zero = GE_V_ZERO(); \
+    const GE_Vec alpha_mask = GE_V_SET32(0xFF000000u); \
+    const GE_Vec color = GE_V_SET32(tint->color & 0x00FFFFFFu); \
+    int n = count & ~(GE_SIMD_LANES - 1); \
+    for (int i = 0; i < n; i += GE_SIMD_LANES) { \
+        GE_Vec cov = GE_V_LOAD_A8(src + i); \
+        GE_Vec skip = GE_V_CMPEQ32(cov, zero); \
+        if (GE_V_MOVEMASK8(skip) == GE_V_MASK_ALL) continue; /* Hueco entre letras */ \
+        GE_Vec sv = GE_V_OR(cov, color); \
+        GE_Vec dv = GE_V_LOAD(dst + i); \
+        GE_Vec slo = GE_V_UNPACKLO8(sv, zero), shi = GE_V_UNPACKHI8(sv, zero); \
+        GE_Vec dlo = GE_V_UNPACKLO8(dv, zero), dhi = GE_V_UNPACKHI8(dv, zero), rlo, rhi; \
+        GE_V_BLEND(MODE, 0, slo, dlo, rlo); \
+        GE_V_BLEND(MODE, 0, shi, dhi, rhi); \
+        GE_Vec res = GE_V_PACKUS16(rlo, rhi); \
+        if ((MODE) != GE_BLEND_ALPHA) res = GE_V_OR(res, alpha_mask); \
+        GE_V_STORE(dst + i, GE_V_OR(GE_V_AND(skip, dv), GE_V_ANDNOT(skip, res))); \
+    } \
+    return n; \
+}
+
+#define GE_DEFINE_SIMD_MODE(MODE_NAME, MODE) \
+    GE_DEFINE_SIMD_SPAN(GE_SimdSpan_##MODE_NAME##Alpha,       MODE, 0, 0) \
+    GE_DEFINE_SIMD_SPAN(GE_SimdSpan_##MODE_NAME##Alpha_Tint,  MODE, 0, 1) \
+    GE_DEFINE_SIMD_SPAN(GE_SimdSpan_##MODE_NAME##Premul,      MODE, 1, 0) \
+    GE_DEFINE_SIMD_SPAN(GE_SimdSpan_##MODE_NAME##Premul_Tint, MODE, 1, 1) \
+    GE_DEFINE_SIMD_SOLID(GE_SimdSolid_##MODE_NAME, MODE) \
+    GE_DEFINE_SIMD_COVERAGE(GE_SimdCoverage_##MODE_NAME, MODE)
+
+GE_DEFINE_SIMD_MODE(Over,   GE_BLEND_ALPHA)
+GE_DEFINE_SIMD_MODE(Add,    GE_BLEND_ADDITIVE)
+GE_DEFINE_SIMD_MODE(Mul,    GE_BLEND_MULTIPLY)
+GE_DEFINE_SIMD_MODE(Screen, GE_BLEND_SCREEN)
+GE_DEFINE_SIMD_MODE(Copy,   GE_BLEND_REPLACE)
+
+// [modo][premultiplicado][tinte]
+static const GE_SimdSpanFn g_simd_span_table[GE_BLEND_MODE_COUNT][2][2] = {
+    { { GE_SimdSpan_OverAlpha,   GE_SimdSpan_OverAlpha_Tint   }, { GE_SimdSpan_OverPremul,   GE_SimdSpan_OverPremul_Tint   } },
+    { { GE_SimdSpan_AddAlpha,    GE_SimdSpan_AddAlpha_Tint    }, { GE_SimdSpan_AddPremul,    GE_SimdSpan_AddPremul_Tint    } },
+    { { GE_SimdSpan_MulAlpha,    GE_SimdSpan_MulAlpha_Tint    }, { GE_SimdSpan_MulPremul,    GE_SimdSpan_MulPremul_Tint    } },
+    { { GE_SimdSpan_ScreenAlpha, GE_SimdSpan_ScreenAlpha_Tint }, { GE_SimdSpan_ScreenPremul, GE_SimdSpan_ScreenPremul_Tint } },
+    { { GE_SimdSpan_CopyAlpha,   GE_SimdSpan_CopyAlpha_Tint   }, { GE_SimdSpan_CopyPremul,   GE_SimdSpan_CopyPremul_Tint   } }
+};
+
+static const GE_SimdSolidFn g_simd_solid_table[GE_BLEND_MODE_COUNT] = {
+    GE_SimdSolid_Over, GE_SimdSolid_Add, GE_SimdSolid_Mul, GE_SimdSolid_Screen, GE_SimdSolid_Copy
+};
+
+static const GE_SimdSpanFn g_simd_coverage_table[GE_BLEND_MODE_COUNT] = {
+    GE_SimdCoverage_Over, GE_SimdCoverage_Add, GE_SimdCoverage_Mul, GE_SimdCoverage_Screen, GE_SimdCoverage_Copy
+};
+
+#endif // SIMD
+
+// Mezcla 'count' píxeles consecutivos con un color sólido (rellenos de primitivas)
+static void GE_BlendSolidSpan(uint32_t* dst, int count, GE_Color color, GE_BlendMode mode) {
+    uint32_t a = color >> 24;
+    if (a == 0 || count <= 0) return;
+    if (mode == GE_BLEND_REPLACE || (mode == GE_BLEND_ALPHA && a == 255)) {
+        uint32_t c = color | 0xFF000000u;
+        for (int i = 0; i < count; i++) dst[i] = c;
+        return;
+    }
+    int done = 0;
+#ifdef GE_SIMD_LANES
+    done = g_simd_solid_table[mode](dst, count, color);
+#endif
+    for (int i = done; i < count; i++) GE_BlendPixel(&dst[i], color, mode);
+}
+
 // ============================================================================
 // PRIMITIVAS GRÁFICAS (DrawPixel, Lines, Rects, Circles...)
 // ============================================================================
 
-// Helper seguro
+// Helper seguro (mezcla con el modo activo del contexto)
 static void GE_PutPixelSafe(GE_Context* ctx, int x, int y, GE_Color color) {
     if (x < 0 || x >= ctx->render_width || y < 0 || y >= ctx->render_height) return;
-    if ((color >> 24) == 0) return; // Transparente
-    ctx->render_buffer[y * ctx->render_width + x] = color;
+    if (ctx->render_queue && GE_RecordSpan(ctx, x, x, y, color)) return;
+    GE_BlendPixel(&ctx->render_buffer[y * ctx->render_width + x], color, ctx->blend_mode);
+}
+
+// Tramo horizontal [x0, x1] (inclusive) recortado a la pantalla. Los rellenos pintan
+// cada píxel una sola vez para que la mezcla no se acumule donde se solapan.
+static void GE_FillSpanSafe(GE_Context* ctx, int x0, int x1, int y, GE_Color color) {
+    if (y < 0 || y >= ctx->render_height) return;
+    if (x0 < 0) x0 = 0;
+    if (x1 >= ctx->render_width) x1 = ctx->render_width - 1;
+    if (x0 > x1) return;
+    if (ctx->render_queue && GE_RecordSpan(ctx, x0, x1, y, color)) return;
+    GE_BlendSolidSpan(&ctx->render_buffer[y * ctx->render_width + x0], x1 - x0 + 1, color, ctx->blend_mode);
 }
 
 void GE_DrawPixel(GE_Context* ctx, float x, float y, GE_Color color) {
@@ -300,11 +979,11 @@ void GE_DrawRect(GE_Context* ctx, float x, float y, float w, float h, GE_Color c
 }
 
 void GE_FillRect(GE_Context* ctx, float x, float y, float w, float h, GE_Color color) {
+    if (!ctx || !ctx->render_buffer) return;
     int ix = (int)x, iy = (int)y, iw = (int)w, ih = (int)h;
+    if (iw <= 0) return;
     for (int j = 0; j < ih; j++) {
-        for (int i = 0; i < iw; i++) {
-            GE_PutPixelSafe(ctx, ix + i, iy + j, color);
-        }
+        GE_FillSpanSafe(ctx, ix, ix + iw - 1, iy + j, color);
     }
 }
 
@@ -323,17 +1002,35 @@ void GE_DrawCircle(GE_Context* ctx, float cx, float cy, float radius, GE_Color c
     }
 }
 
+// Filas y0 - d e y0 + d (una sola si d = 0) con semiancho h
+static inline void GE_FillCircleRows(GE_Context* ctx, int x0, int y0, int d, int h, GE_Color color) {
+    GE_FillSpanSafe(ctx, x0 - h, x0 + h, y0 + d, color);
+    if (d) GE_FillSpanSafe(ctx, x0 - h, x0 + h, y0 - d, color);
+}
+
 void GE_FillCircle(GE_Context* ctx, float cx, float cy, float radius, GE_Color color) {
     if (radius <= 0) { GE_DrawPixel(ctx, cx, cy, color); return; }
     int x0 = (int)cx, y0 = (int)cy, r = (int)radius;
-    int x = r, y = 0, err = 0;
-    while (x >= y) {
-        GE_DrawLine(ctx, x0 - x, y0 - y, x0 + x, y0 - y, color);
-        GE_DrawLine(ctx, x0 - x, y0 + y, x0 + x, y0 + y, color);
-        GE_DrawLine(ctx, x0 - y, y0 - x, x0 + y, y0 - x, color);
-        GE_DrawLine(ctx, x0 - y, y0 + x, x0 + y, y0 + x, color);
+    if (!ctx || !ctx->render_buffer || x0 + r < 0 || y0 + r < 0 ||
+        x0 - r >= ctx->render_width || y0 - r >= ctx->render_height) return;
+
+    // El punto medio visita varias veces las mismas filas; cada una se pinta una sola vez
+    // con su semiancho máximo. Octante bajo (fila y): el primer x visto, el mayor.
+    // Octante alto (fila x): el último y antes de que x baje, salvo que la fila
+    // coincida con la diagonal, que ya pintó el octante bajo con un semiancho mayor.
+    // Más allá de 'reach' filas del centro todo cae fuera de la pantalla (y en el octante
+    // alto las filas son siempre >= y)
+    int reach = y0 > ctx->render_height - 1 - y0 ? y0 : ctx->render_height - 1 - y0;
+    int x = r, y = 0, err = 0, last_row = -1;
+    while (x >= y && y <= reach) {
+        int px = x, py = y;
+        if (py > last_row) {
+            GE_FillCircleRows(ctx, x0, y0, py, px, color);
+            last_row = py;
+        }
         if (err <= 0) { y += 1; err += 2 * y + 1; }
         if (err > 0) { x -= 1; err -= 2 * x + 1; }
+        if ((x != px || x < y) && px != py) GE_FillCircleRows(ctx, x0, y0, px, py, color);
     }
 }
 
@@ -345,13 +1042,21 @@ void GE_DrawEllipse(GE_Context* ctx, float cx, float cy, float rx, float ry, GE_
     }
 }
 
+static inline bool GE_InsideEllipse(int x, int y, float rx, float ry) {
+    return ((float)(x*x)/(rx*rx)) + ((float)(y*y)/(ry*ry)) <= 1.0f;
+}
+
 void GE_FillEllipse(GE_Context* ctx, float cx, float cy, float rx, float ry, GE_Color color) {
+    if (rx <= 0 || ry <= 0) return;
     int irx = (int)rx, iry = (int)ry;
     for(int y = -iry; y <= iry; y++) {
-        for(int x = -irx; x <= irx; x++) {
-            if(((float)(x*x)/(rx*rx)) + ((float)(y*y)/(ry*ry)) <= 1.0f)
-                GE_PutPixelSafe(ctx, (int)cx + x, (int)cy + y, color);
-        }
+        // Semiancho de la fila: estimación directa y ajuste con el mismo test de siempre
+        float k = 1.0f - (float)(y*y) / (ry*ry);
+        int xm = (int)(rx * sqrtf(k > 0.0f ? k : 0.0f));
+        if (xm > irx) xm = irx;
+        while (xm >= 0 && !GE_InsideEllipse(xm, y, rx, ry)) xm--;
+        while (xm < irx && GE_InsideEllipse(xm + 1, y, rx, ry)) xm++;
+        if (xm >= 0) GE_FillSpanSafe(ctx, (int)cx - xm, (int)cx + xm, (int)cy + y, color);
     }
 }
 
@@ -461,18 +1166,43 @@ void GE_DrawArc(GE_Context* ctx, float cx, float cy, float radius, float start_d
 }
 
 void GE_FillSector(GE_Context* ctx, float cx, float cy, float radius, float start_deg, float end_deg, GE_Color color) {
-    // Dibujamos líneas desde el centro hacia el borde del arco (como rebanadas de pizza muy finas)
-    // No es el método más rápido (overdraw), pero es muy sencillo de implementar.
-    float step = 1.0f / radius; // Paso muy fino para que no queden huecos
-    if (step > 0.01f) step = 0.01f;
-
+    // Test por píxel (distancia + ángulo) dentro de la caja del círculo: cada píxel se
+    // pinta una sola vez, así los modos de mezcla no se acumulan como con las "rebanadas".
+    if (!ctx || !ctx->render_buffer || radius <= 0) return;
+    const float two_pi = 2.0f * 3.14159f;
     float start_rad = start_deg * 3.14159f / 180.0f;
-    float end_rad = end_deg * 3.14159f / 180.0f;
-
-    for (float angle = start_rad; angle <= end_rad; angle += step) {
-        float x = cx + cosf(angle) * radius;
-        float y = cy + sinf(angle) * radius;
-        GE_DrawLine(ctx, cx, cy, x, y, color);
+    float sweep = (end_deg - start_deg) * 3.14159f / 180.0f;
+    if (sweep < 0) return;
+
+    int min_x = (int)floorf(cx - radius), max_x = (int)ceilf(cx + radius);
+    int min_y = (int)floorf(cy - radius), max_y = (int)ceilf(cy + radius);
+    if (min_x < 0) min_x = 0;
+    if (min_y < 0) min_y = 0;
+    if (max_x >= ctx->render_width) max_x = ctx->render_width - 1;
+    if (max_y >= ctx->render_height) max_y = ctx->render_height - 1;
+
+    // Los píxeles dentro se agrupan en tramos contiguos por fila
+    float r2 = radius * radius;
+    for (int y = min_y; y <= max_y; y++) {
+        float dy = (float)y + 0.5f - cy;
+        int run = -1; // Inicio del tramo abierto
+        for (int x = min_x; x <= max_x + 1; x++) {
+            bool inside = false;
+            if (x <= max_x) {
+                float dx = (float)x + 0.5f - cx;
+                inside = dx * dx + dy * dy <= r2;
+                if (inside && sweep < two_pi) {
+                    float a = fmodf(atan2f(dy, dx) - start_rad, two_pi);
+                    if (a < 0) a += two_pi;
+                    inside = a <= sweep;
+                }
+            }
+            if (inside && run < 0) run = x;
+            if (!inside && run >= 0) {
+                GE_FillSpanSafe(ctx, run, x - 1, y, color);
+                run = -1;
+            }
+        }
     }
 }
 
@@ -584,594 +1314,5404 @@ int GE_GetHeight(GE_Context* ctx) { return ctx ? ctx->render_height : 0; }
 // 6. IMPLEMENTACIÓN DE SPRITES Y ANIMACIONES
 // ============================================================================
 
+// Paleta de un sprite indexado (8 bpp). Sus sub-sprites la comparten.
+typedef struct {
+    uint32_t colors[256]; // RGBA en orden de memoria, igual que un texel de 4 bytes
+    int count;            // Entradas en uso
+    bool opaque;          // Todas las entradas en uso tienen alpha 255
+    uint32_t serial;      // Se renueva con cada cambio (clave de las cachés)
+} GE_Palette;
+
+// Máscara de colisión: 1 bit por píxel del cuadro lógico, filas de palabras de 64 bits
+// (bit i de la palabra k = columna 64k + i). Se guarda la caja de los bits a 1.
+typedef struct {
+    uint64_t* bits;
+    int words_per_row;
+    int x0, y0, x1, y1; // Caja [x0, x1) x [y0, y1); vacía si x0 >= x1
+} GE_CollisionMask;
+
 struct GE_Sprite {
     int width;
     int height;
-    int channels;       // Generalmente 4 (RGBA)
-    unsigned char* data; // Píxeles crudos (byte a byte: R, G, B, A, R, G, B, A...)
-};
+    int channels;       // 4 (RGBA) o 1 (índice de paleta)
+    unsigned char* data; // Píxeles crudos (byte a byte: R, G, B, A, R, G, B, A... o un índice por texel)
+    int pitch;          // Bytes por fila de 'data' (en un atlas es el ancho de la página)
 
-// --- Helper para mezclar colores (Alpha Blending) ---
-// Mezcla un color nuevo (fg) sobre el color existente (bg) respetando la transparencia
-static GE_Color GE_BlendColors(GE_Color bg, GE_Color fg, uint8_t alpha_sprite) {
-    // Si el sprite es totalmente transparente, no hacemos nada
-    if (alpha_sprite == 0) return bg;
-    
-    // Extraer componentes del Fondo (Background)
-    uint8_t bg_a = (bg >> 24) & 0xFF;
-    uint8_t bg_r = (bg >> 16) & 0xFF;
-    uint8_t bg_g = (bg >> 8)  & 0xFF;
-    uint8_t bg_b = bg & 0xFF;
+    // Zona realmente almacenada dentro del cuadro lógico width x height.
+    // Fuera de ella todo es transparente (bordes recortados por el atlas).
+    // 'data' apunta al píxel (trim_x, trim_y).
+    int trim_x, trim_y, trim_w, trim_h;
 
-    // Extraer componentes del Frente (Foreground/Sprite)
-    uint8_t fg_a = (fg >> 24) & 0xFF;
-    uint8_t fg_r = (fg >> 16) & 0xFF;
-    uint8_t fg_g = (fg >> 8)  & 0xFF;
-    uint8_t fg_b = fg & 0xFF;
+    bool owns_data;     // false -> vista sobre memoria ajena (página de atlas)
+    bool atlas_owned;   // true  -> el struct lo libera GE_UnloadAtlas
 
-    // Combinar el alpha del píxel con el alpha global (si quisiéramos tintes semitransparentes)
-    // Por ahora usamos el alpha del píxel directo.
-    
-    // Fórmula estándar de Alpha Blending:
-    // Out = (Alpha * Fg + (255 - Alpha) * Bg) / 255
-    uint16_t alpha = alpha_sprite;
-    uint16_t inv_alpha = 255 - alpha;
+    // Mipmaps opcionales: mips[i] es el nivel i+1 (mitad de tamaño que el anterior)
+    struct GE_Sprite** mips;
+    int mip_count;
+    bool mips_enabled;  // true -> generar al primer dibujo reducido si aún no existen
 
-    uint8_t out_r = (uint8_t)((alpha * fg_r + inv_alpha * bg_r) / 255);
-    uint8_t out_g = (uint8_t)((alpha * fg_g + inv_alpha * bg_g) / 255);
-    uint8_t out_b = (uint8_t)((alpha * fg_b + inv_alpha * bg_b) / 255);
-    uint8_t out_a = 255; // El resultado en pantalla siempre es opaco
+    // Tipo de fuente para elegir el blitter especializado
+    bool opaque;        // Todos los texels almacenados tienen alpha 255
+    bool premultiplied; // RGB ya multiplicado por alpha (en vistas manda el del dueño: GE_SpriteDataPremultiplied)
+    struct GE_Sprite* parent; // Vistas (sub-sprites): dueño de los píxeles; NULL en el resto
 
-    return (out_a << 24) | (out_r << 16) | (out_g << 8) | out_b;
-}
+    // Identificador único: las cachés lo usan como clave (un puntero liberado puede reutilizarse)
+    uint32_t serial;
 
-GE_Sprite* GE_LoadSprite(const char* filepath) {
-    GE_Sprite* spr = (GE_Sprite*)malloc(sizeof(GE_Sprite));
-    if (!spr) return NULL;
+    // Color indexado: NULL -> texels RGBA de 4 bytes
+    GE_Palette* palette;
+    bool owns_palette;  // false -> paleta del padre (sub-sprite) hasta que se cambie
 
-    // Forzamos 4 canales (RGBA) para facilitar el dibujo
-    spr->data = stbi_load(filepath, &spr->width, &spr->height, &spr->channels, 4);
-    
-    if (!spr->data) {
-        printf("[GE] Error cargando sprite: %s\n", filepath);
-        free(spr);
-        return NULL;
-    }
-    
-    return spr;
-}
+    // Cobertura A8 (páginas de glifos): un byte de alpha por texel, el color lo pone el tinte.
+    // Solo la dibuja el blitter alineado a ejes.
+    bool coverage;
 
-void GE_UnloadSprite(GE_Sprite* sprite) {
-    if (sprite) {
-        if (sprite->data) stbi_image_free(sprite->data);
-        free(sprite);
-    }
-}
+    // Colisión por píxel (se genera en GE_BuildSpriteMask o en la primera consulta)
+    GE_CollisionMask* mask;
+};
 
-int GE_GetSpriteWidth(GE_Sprite* sprite) {
-    return sprite ? sprite->width : 0;
+static volatile ma_uint32 g_sprite_serial = 0;
+
+static inline uint32_t GE_NextSpriteSerial(void) {
+    return ma_atomic_fetch_add_32(&g_sprite_serial, 1) + 1; // También desde el hilo de fuentes
 }
 
-int GE_GetSpriteHeight(GE_Sprite* sprite) {
-    return sprite ? sprite->height : 0;
+// Inicializa un sprite "normal": sin recorte y con filas contiguas
+static void GE_InitSpriteFull(GE_Sprite* spr, int width, int height, unsigned char* data, bool owns_data) {
+    spr->width = width;
+    spr->height = height;
+    spr->channels = 4;
+    spr->data = data;
+    spr->pitch = width * 4;
+    spr->trim_x = 0;
+    spr->trim_y = 0;
+    spr->trim_w = width;
+    spr->trim_h = height;
+    spr->owns_data = owns_data;
+    spr->atlas_owned = false;
+    spr->serial = GE_NextSpriteSerial();
 }
 
-void GE_DrawSprite(GE_Context* ctx, GE_Sprite* sprite, float x, float y, GE_Color tint) {
-    if (!sprite || !sprite->data) return;
-    
-    // Usamos DrawSpriteEx para no repetir código, asumiendo rect completo
-    GE_Rect src = { 0, 0, (float)sprite->width, (float)sprite->height };
-    GE_Rect dst = { x, y, (float)sprite->width, (float)sprite->height };
-    GE_DrawSpriteEx(ctx, sprite, src, dst, tint);
+// Bytes por texel en 'data'
+static inline int GE_TexelBytes(const GE_Sprite* s) {
+    return (s->palette || s->coverage) ? 1 : 4;
 }
 
-void GE_DrawSpriteEx(GE_Context* ctx, GE_Sprite* sprite, GE_Rect src, GE_Rect dest, GE_Color tint) {
-    if (!ctx || !sprite || !sprite->data) return;
+// En un sprite indexado la opacidad depende de la paleta (puede cambiar en cualquier momento)
+static inline bool GE_SpriteIsOpaque(const GE_Sprite* s) {
+    return s->palette ? s->palette->opaque : s->opaque;
+}
 
-    // Coordenadas enteras para iterar
-    int dest_x = (int)dest.x;
-    int dest_y = (int)dest.y;
-    int dest_w = (int)dest.w;
-    int dest_h = (int)dest.h;
+// Formato real de los píxeles: una vista no se entera de un GE_PremultiplySprite posterior del dueño
+static inline bool GE_SpriteDataPremultiplied(const GE_Sprite* s) {
+    return s->parent ? s->parent->premultiplied : s->premultiplied;
+}
 
-    int src_x = (int)src.x;
-    int src_y = (int)src.y;
-    int src_w = (int)src.w;
-    
-    // Clipping básico: Si está totalmente fuera de pantalla, no dibujamos
-    if (dest_x >= ctx->render_width || dest_y >= ctx->render_height || 
-        dest_x + dest_w <= 0 || dest_y + dest_h <= 0) return;
-
-    // Tinte (Tint) - Extraer componentes para multiplicar
-    uint8_t tint_r = (tint >> 16) & 0xFF;
-    uint8_t tint_g = (tint >> 8)  & 0xFF;
-    uint8_t tint_b = tint & 0xFF;
-
-    // Recorremos los píxeles de DESTINO (Pantalla)
-    for (int dy = 0; dy < dest_h; dy++) {
-        int screen_y = dest_y + dy;
-        if (screen_y < 0 || screen_y >= ctx->render_height) continue;
-
-        // Calculamos qué fila del sprite corresponde (Nearest Neighbor scaling)
-        int sy = (dy * (int)src.h) / dest_h;
-        int sprite_row_offset = (src_y + sy) * sprite->width * 4;
-
-        for (int dx = 0; dx < dest_w; dx++) {
-            int screen_x = dest_x + dx;
-            if (screen_x < 0 || screen_x >= ctx->render_width) continue;
-
-            // Calculamos columna del sprite
-            int sx = (dx * (int)src.w) / dest_w;
-            int sprite_idx = sprite_row_offset + ((src_x + sx) * 4);
-
-            // Leer color del sprite
-            uint8_t r = sprite->data[sprite_idx + 0];
-            uint8_t g = sprite->data[sprite_idx + 1];
-            uint8_t b = sprite->data[sprite_idx + 2];
-            uint8_t a = sprite->data[sprite_idx + 3];
-
-            if (a == 0) continue; // Totalmente transparente, saltar
-
-            // Aplicar Tinte (Multiplicativo)
-            if (tint != 0xFFFFFFFF) {
-                r = (r * tint_r) / 255;
-                g = (g * tint_g) / 255;
-                b = (b * tint_b) / 255;
-            }
+// Los 4 bytes RGBA del texel (tx, ty) de la zona almacenada (en indexados, la entrada de paleta)
+static inline const unsigned char* GE_TexelAddress(const GE_Sprite* s, int tx, int ty) {
+    if (s->palette) return (const unsigned char*)&s->palette->colors[s->data[ty * s->pitch + tx]];
+    return &s->data[ty * s->pitch + tx * 4];
+}
 
-            GE_Color fg_color = (a << 24) | (r << 16) | (g << 8) | b;
-            
-            // Obtener color actual de fondo para mezclar
-            GE_Color bg_color = ctx->render_buffer[screen_y * ctx->render_width + screen_x];
-            
-            // Mezclar y pintar
-            ctx->render_buffer[screen_y * ctx->render_width + screen_x] = GE_BlendColors(bg_color, fg_color, a);
+// Marca el sprite como opaco si toda su zona almacenada tiene alpha 255
+static void GE_DetectOpaque(GE_Sprite* spr) {
+    spr->opaque = false;
+    if (!spr->data || spr->palette || spr->coverage) return; // Indexado: lo decide la paleta
+    for (int y = 0; y < spr->trim_h; y++) {
+        const unsigned char* row = spr->data + y * spr->pitch;
+        for (int x = 0; x < spr->trim_w; x++) {
+            if (row[x * 4 + 3] != 255) return;
         }
     }
+    spr->opaque = true;
 }
 
-// Nota: DrawSpritePro (Rotación) requiere matemáticas de textura complejas 
-// (inverse mapping) que son lentas en CPU pura. Por ahora usaremos el Ex (Escalado/Recorte).
-void GE_DrawSpritePro(GE_Context* ctx, GE_Sprite* sprite, GE_Rect src, GE_Rect dest, GE_Point origin, float rotation, GE_Color tint) {
-    // TODO: Implementar rotación por software (Bilineal o Nearest Neighbor rotado)
-    // Por ahora, redirigimos a Ex ignorando rotación para que no crashee.
-    GE_Rect final_dest = { dest.x - origin.x, dest.y - origin.y, dest.w, dest.h };
-    GE_DrawSpriteEx(ctx, sprite, src, final_dest, tint);
+// --- BLITTERS ESPECIALIZADOS ---
+// En vez de un bucle genérico que pregunta en cada píxel "¿hay tinte?", "¿escalado?",
+// generamos con macros una variante por combinación (modo de mezcla x tipo de fuente x
+// escalado x tinte) y el despachador elige UNA vez por llamada. Dentro del bucle solo
+// quedan las ramas que dependen del dato (alpha 0 se salta, alpha 255 se copia).
+// Los spans sin escalar ni espejo pasan primero por el núcleo SIMD del modo.
+
+// Tipo de fuente
+enum { GE_SRC_OPAQUE = 0, GE_SRC_ALPHA, GE_SRC_PREMUL, GE_SRC_KIND_COUNT };
+
+// Avance horizontal dentro de un span
+typedef struct {
+    int sx, rem;            // Texel inicial (relativo al rect fuente) y resto del acumulador
+    int step_int, step_rem; // Paso entero y resto por píxel (solo variantes escaladas)
+    int dest_w;             // Divisor del acumulador
+    int dir;                // +/- bytes por texel (negativo con espejo)
+    const uint32_t* palette; // Solo variantes indexadas
+} GE_SpanStep;
+
+typedef void (*GE_SpanFn)(uint32_t* dst, int count, const unsigned char* data, int off, const GE_SpanStep* st, const GE_Tint* tint);
+
+// Un solo texel (rasterizador de quads, donde cada píxel lee una posición arbitraria)
+typedef void (*GE_TexelFn)(uint32_t* dst, const unsigned char* px, const GE_Tint* tint);
+
+// Piezas por píxel
+#define GE_TINT_ON(r, g, b, t)  do { r = (r * (t)->r) / 255; g = (g * (t)->g) / 255; b = (b * (t)->b) / 255; } while (0)
+#define GE_TINT_OFF(r, g, b, t) do { } while (0)
+
+// SCALED, SKIP_ZERO e INDEXED son constantes 0/1: el compilador elimina la rama que no aplica.
+// Las variantes indexadas leen un byte y expanden con la paleta en el mismo bucle.
+#define GE_DEFINE_SPAN(NAME, SCALED, TINT, SKIP_ZERO, STORE, INDEXED) \
+static void NAME(uint32_t* dst, int count, const unsigned char* data, int off, const GE_SpanStep* st, const GE_Tint* tint) { \
+    int sx = st->sx, rem = st->rem, dir = st->dir; \
+    int step_int = st->step_int, step_rem = st->step_rem, dest_w = st->dest_w; \
+    (void)step_int; (void)step_rem; (void)dest_w; (void)tint; \
+    for (int i = 0; i < count; i++) { \
+        const unsigned char* px = INDEXED ? (const unsigned char*)&st->palette[data[off + sx * dir]] \
+                                          : &data[off + sx * dir]; \
+        if (SCALED) { \
+            sx += step_int; \
+            rem += step_rem; \
+            if (rem >= dest_w) { rem -= dest_w; sx++; } \
+        } else { \
+            sx++; \
+        } \
+        uint32_t a = px[3]; \
+        if (SKIP_ZERO && a == 0) continue; \
+        uint32_t r = px[0], g = px[1], b = px[2]; \
+        TINT(r, g, b, tint); \
+        STORE(&dst[i], r, g, b, a); \
+    } \
 }
 
-void GE_DrawSpriteQuad(GE_Context* c, GE_Sprite* s, GE_Point p1, GE_Point p2, GE_Point p3, GE_Point p4, GE_Color t) {
-    // Placeholder para deformación de sprites (Quad warping)
+#define GE_DEFINE_TEXEL(NAME, SKIP_ZERO, STORE) \
+static void NAME(uint32_t* dst, const unsigned char* px, const GE_Tint* tint) { \
+    uint32_t a = px[3]; \
+    if (SKIP_ZERO && a == 0) return; \
+    uint32_t r = px[0], g = px[1], b = px[2]; \
+    if (tint->color != 0xFFFFFFFF) GE_TINT_ON(r, g, b, tint); \
+    STORE(dst, r, g, b, a); \
 }
 
-// --- SISTEMA DE ANIMACIÓN ---
+#define GE_DEFINE_SPAN_VARIANTS(PREFIX, KIND, SKIP_ZERO, STORE, INDEXED) \
+    GE_DEFINE_SPAN(PREFIX##_##KIND##_Plain,      0, GE_TINT_OFF, SKIP_ZERO, STORE, INDEXED) \
+    GE_DEFINE_SPAN(PREFIX##_##KIND##_Tint,       0, GE_TINT_ON,  SKIP_ZERO, STORE, INDEXED) \
+    GE_DEFINE_SPAN(PREFIX##_##KIND##_Scaled,     1, GE_TINT_OFF, SKIP_ZERO, STORE, INDEXED) \
+    GE_DEFINE_SPAN(PREFIX##_##KIND##_ScaledTint, 1, GE_TINT_ON,  SKIP_ZERO, STORE, INDEXED)
+
+#define GE_DEFINE_SPAN_SET(KIND, SKIP_ZERO, STORE) \
+    GE_DEFINE_SPAN_VARIANTS(GE_Span, KIND, SKIP_ZERO, STORE, 0) \
+    GE_DEFINE_TEXEL(GE_Texel_##KIND, SKIP_ZERO, STORE)
+
+// Indexadas: la paleta se guarda en alpha recto, así que no hay variante premultiplicada
+#define GE_DEFINE_INDEXED_SPAN_SET(KIND, SKIP_ZERO, STORE) \
+    GE_DEFINE_SPAN_VARIANTS(GE_SpanIdx, KIND, SKIP_ZERO, STORE, 1)
+
+// ALPHA
+GE_DEFINE_SPAN_SET(OverOpaque,   0, GE_STORE_OPAQUE)
+GE_DEFINE_SPAN_SET(OverAlpha,    1, GE_STORE_ALPHA)
+GE_DEFINE_SPAN_SET(OverPremul,   1, GE_STORE_PREMUL)
+// ADDITIVE
+GE_DEFINE_SPAN_SET(AddOpaque,    0, GE_OP_ADD)
+GE_DEFINE_SPAN_SET(AddAlpha,     1, GE_STORE_ADD)
+GE_DEFINE_SPAN_SET(AddPremul,    1, GE_OP_ADD)
+// MULTIPLY
+GE_DEFINE_SPAN_SET(MulOpaque,    0, GE_OP_MULTIPLY)
+GE_DEFINE_SPAN_SET(MulAlpha,     1, GE_STORE_MULTIPLY)
+GE_DEFINE_SPAN_SET(MulPremul,    1, GE_OP_MULTIPLY)
+// SCREEN
+GE_DEFINE_SPAN_SET(ScreenOpaque, 0, GE_OP_SCREEN)
+GE_DEFINE_SPAN_SET(ScreenAlpha,  1, GE_STORE_SCREEN)
+GE_DEFINE_SPAN_SET(ScreenPremul, 1, GE_OP_SCREEN)
+// REPLACE (opaca = ALPHA opaca; la premultiplicada escribe el color recto)
+GE_DEFINE_SPAN_SET(Copy,         1, GE_STORE_OPAQUE)
+GE_DEFINE_SPAN_SET(CopyPremul,   1, GE_STORE_UNPREMUL)
+
+GE_DEFINE_INDEXED_SPAN_SET(OverOpaque,   0, GE_STORE_OPAQUE)
+GE_DEFINE_INDEXED_SPAN_SET(OverAlpha,    1, GE_STORE_ALPHA)
+GE_DEFINE_INDEXED_SPAN_SET(AddOpaque,    0, GE_OP_ADD)
+GE_DEFINE_INDEXED_SPAN_SET(AddAlpha,     1, GE_STORE_ADD)
+GE_DEFINE_INDEXED_SPAN_SET(MulOpaque,    0, GE_OP_MULTIPLY)
+GE_DEFINE_INDEXED_SPAN_SET(MulAlpha,     1, GE_STORE_MULTIPLY)
+GE_DEFINE_INDEXED_SPAN_SET(ScreenOpaque, 0, GE_OP_SCREEN)
+GE_DEFINE_INDEXED_SPAN_SET(ScreenAlpha,  1, GE_STORE_SCREEN)
+GE_DEFINE_INDEXED_SPAN_SET(Copy,         1, GE_STORE_OPAQUE)
+
+// Cobertura A8: el texel es el alpha y el color sale del tinte (mismo resultado que un
+// texel blanco tintado, sin desempaquetar RGBA ni multiplicar el tinte por píxel)
+#define GE_DEFINE_COVERAGE_SPAN(NAME, SCALED, STORE) \
+static void NAME(uint32_t* dst, int count, const unsigned char* data, int off, const GE_SpanStep* st, const GE_Tint* tint) { \
+    int sx = st->sx, rem = st->rem, dir = st->dir; \
+    int step_int = st->step_int, step_rem = st->step_rem, dest_w = st->dest_w; \
+    (void)step_int; (void)step_rem; (void)dest_w; \
+    for (int i = 0; i < count; i++) { \
+        uint32_t a = data[off + sx * dir]; \
+        if (SCALED) { \
+            sx += step_int; \
+            rem += step_rem; \
+            if (rem >= dest_w) { rem -= dest_w; sx++; } \
+        } else { \
+            sx++; \
+        } \
+        if (a == 0) continue; \
+        uint32_t r = tint->r, g = tint->g, b = tint->b; \
+        STORE(&dst[i], r, g, b, a); \
+    } \
+}
 
-GE_Animation GE_CreateAnimation(GE_Sprite* sprite, int frame_w, int frame_h, float duration) {
-    GE_Animation anim = {0};
-    anim.sprite = sprite;
-    anim.frame_w = frame_w;
-    anim.frame_h = frame_h;
-    anim.frame_duration = duration;
-    
-    if (sprite) {
-        // Calcular cuántos frames caben horizontalmente
-        int cols = sprite->width / frame_w;
-        // int rows = sprite->height / frame_h; 
-        // Asumimos spritesheet horizontal simple por defecto, pero se puede configurar
-        anim.start_frame = 0;
-        anim.end_frame = cols - 1;
-    }
-    
-    anim.active = true;
-    anim.loop = true;
-    return anim;
+#define GE_DEFINE_COVERAGE_SPAN_SET(KIND, STORE) \
+    GE_DEFINE_COVERAGE_SPAN(GE_SpanCov_##KIND,        0, STORE) \
+    GE_DEFINE_COVERAGE_SPAN(GE_SpanCov_##KIND##_Scaled, 1, STORE)
+
+GE_DEFINE_COVERAGE_SPAN_SET(Over,   GE_STORE_ALPHA)
+GE_DEFINE_COVERAGE_SPAN_SET(Add,    GE_STORE_ADD)
+GE_DEFINE_COVERAGE_SPAN_SET(Mul,    GE_STORE_MULTIPLY)
+GE_DEFINE_COVERAGE_SPAN_SET(Screen, GE_STORE_SCREEN)
+GE_DEFINE_COVERAGE_SPAN_SET(Copy,   GE_STORE_OPAQUE)
+
+#define GE_SPAN_ROW(KIND) \
+    { { GE_Span_##KIND##_Plain, GE_Span_##KIND##_Tint }, { GE_Span_##KIND##_Scaled, GE_Span_##KIND##_ScaledTint } }
+
+// [modo][tipo de fuente][escalado][tinte]
+static const GE_SpanFn g_span_table[GE_BLEND_MODE_COUNT][GE_SRC_KIND_COUNT][2][2] = {
+    { GE_SPAN_ROW(OverOpaque),   GE_SPAN_ROW(OverAlpha),   GE_SPAN_ROW(OverPremul)   },
+    { GE_SPAN_ROW(AddOpaque),    GE_SPAN_ROW(AddAlpha),    GE_SPAN_ROW(AddPremul)    },
+    { GE_SPAN_ROW(MulOpaque),    GE_SPAN_ROW(MulAlpha),    GE_SPAN_ROW(MulPremul)    },
+    { GE_SPAN_ROW(ScreenOpaque), GE_SPAN_ROW(ScreenAlpha), GE_SPAN_ROW(ScreenPremul) },
+    { GE_SPAN_ROW(OverOpaque),   GE_SPAN_ROW(Copy),        GE_SPAN_ROW(CopyPremul)   }
+};
+
+#define GE_SPAN_IDX_ROW(KIND) \
+    { { GE_SpanIdx_##KIND##_Plain, GE_SpanIdx_##KIND##_Tint }, { GE_SpanIdx_##KIND##_Scaled, GE_SpanIdx_##KIND##_ScaledTint } }
+
+// [modo][opaca / alpha][escalado][tinte]
+static const GE_SpanFn g_span_indexed_table[GE_BLEND_MODE_COUNT][2][2][2] = {
+    { GE_SPAN_IDX_ROW(OverOpaque),   GE_SPAN_IDX_ROW(OverAlpha)   },
+    { GE_SPAN_IDX_ROW(AddOpaque),    GE_SPAN_IDX_ROW(AddAlpha)    },
+    { GE_SPAN_IDX_ROW(MulOpaque),    GE_SPAN_IDX_ROW(MulAlpha)    },
+    { GE_SPAN_IDX_ROW(ScreenOpaque), GE_SPAN_IDX_ROW(ScreenAlpha) },
+    { GE_SPAN_IDX_ROW(OverOpaque),   GE_SPAN_IDX_ROW(Copy)        }
+};
+
+// [modo][escalado]
+static const GE_SpanFn g_span_coverage_table[GE_BLEND_MODE_COUNT][2] = {
+    { GE_SpanCov_Over,   GE_SpanCov_Over_Scaled   },
+    { GE_SpanCov_Add,    GE_SpanCov_Add_Scaled    },
+    { GE_SpanCov_Mul,    GE_SpanCov_Mul_Scaled    },
+    { GE_SpanCov_Screen, GE_SpanCov_Screen_Scaled },
+    { GE_SpanCov_Copy,   GE_SpanCov_Copy_Scaled   }
+};
+
+// [modo][tipo de fuente]
+static const GE_TexelFn g_texel_table[GE_BLEND_MODE_COUNT][GE_SRC_KIND_COUNT] = {
+    { GE_Texel_OverOpaque,   GE_Texel_OverAlpha,   GE_Texel_OverPremul   },
+    { GE_Texel_AddOpaque,    GE_Texel_AddAlpha,    GE_Texel_AddPremul    },
+    { GE_Texel_MulOpaque,    GE_Texel_MulAlpha,    GE_Texel_MulPremul    },
+    { GE_Texel_ScreenOpaque, GE_Texel_ScreenAlpha, GE_Texel_ScreenPremul },
+    { GE_Texel_OverOpaque,   GE_Texel_Copy,        GE_Texel_CopyPremul   }
+};
+
+static inline int GE_SourceKind(const GE_Sprite* sprite) {
+    return GE_SpriteIsOpaque(sprite) ? GE_SRC_OPAQUE : (GE_SpriteDataPremultiplied(sprite) ? GE_SRC_PREMUL : GE_SRC_ALPHA);
 }
 
-void GE_UpdateAnimation(GE_Animation* anim, float dt) {
-    if (!anim || !anim->active) return;
+// Despachador: se llama una vez por dibujo, nunca por píxel
+static inline GE_SpanFn GE_SelectSpan(const GE_Sprite* sprite, GE_BlendMode mode, bool scaled, const GE_Tint* tint) {
+    if (sprite->coverage) return g_span_coverage_table[mode][scaled ? 1 : 0];
+    if (sprite->palette) return g_span_indexed_table[mode][GE_SourceKind(sprite)][scaled ? 1 : 0][tint->color != 0xFFFFFFFF ? 1 : 0];
+    return g_span_table[mode][GE_SourceKind(sprite)][scaled ? 1 : 0][tint->color != 0xFFFFFFFF ? 1 : 0];
+}
 
-    anim->timer += dt;
-    if (anim->timer >= anim->frame_duration) {
-        anim->timer = 0;
-        anim->current_frame++;
-        
-        if (anim->current_frame > anim->end_frame) {
-            if (anim->loop) {
-                anim->current_frame = anim->start_frame;
-            } else {
-                anim->current_frame = anim->end_frame;
-                anim->active = false; // Detener si no es loop
-            }
-        }
+#ifdef GE_SIMD_LANES
+// Núcleo SIMD para spans 1:1 sin espejo. Con fuente opaca ALPHA equivale a REPLACE
+// (solo reordena canales) y el resto de modos usa la variante recta con A = 255.
+// Los indexados van siempre por el span escalar (NULL).
+static inline GE_SimdSpanFn GE_SelectSimdSpan(const GE_Sprite* sprite, GE_BlendMode mode, const GE_Tint* tint) {
+    if (sprite->palette) return NULL;
+    if (sprite->coverage) return g_simd_coverage_table[mode];
+    int tinted = tint->color != 0xFFFFFFFF ? 1 : 0;
+    if (sprite->opaque) {
+        if (mode == GE_BLEND_ALPHA) mode = GE_BLEND_REPLACE;
+        return g_simd_span_table[mode][0][tinted];
     }
+    return g_simd_span_table[mode][GE_SpriteDataPremultiplied(sprite) ? 1 : 0][tinted];
 }
+#endif
 
-void GE_DrawAnimation(GE_Context* ctx, GE_Animation* anim, float x, float y, bool flip_x, GE_Color tint) {
-    if (!anim || !anim->sprite) return;
+// --- FILTRO BILINEAL ---
+// Opcional para dibujos escalados y rotados/deformados. Cada píxel destino mezcla los
+// 4 texels vecinos con pesos de 8 bits en punto fijo. Se trabaja en tres pasos por
+// tramos de GE_FILTER_CHUNK píxeles:
+//   1. Recolección (escalar): los 4 vecinos y los pesos de cada píxel.
+//   2. Resolución (SSE2, 4 píxeles por iteración): interpolación en alpha premultiplicado
+//      (si no, los bordes transparentes dejan un halo oscuro).
+//   3. Mezcla: los mismos núcleos de span de fuente premultiplicada y el modo activo.
+// Fuera de la zona almacenada (bordes recortados) los vecinos cuentan como transparentes.
+
+#define GE_FILTER_CHUNK 64
+
+typedef struct {
+    uint32_t tl[GE_FILTER_CHUNK], tr[GE_FILTER_CHUNK]; // Vecinos RGBA (orden de memoria)
+    uint32_t bl[GE_FILTER_CHUNK], br[GE_FILTER_CHUNK];
+    uint16_t fx[GE_FILTER_CHUNK], fy[GE_FILTER_CHUNK]; // Pesos 0..255 del vecino derecho/inferior
+    unsigned char out[GE_FILTER_CHUNK * 4];             // Resultado RGBA premultiplicado
+} GE_BilinearChunk;
+
+void GE_SetTextureFilter(GE_Context* ctx, GE_TextureFilter filter) {
+    if (!ctx) return;
+    ctx->texture_filter = (filter == GE_FILTER_BILINEAR) ? GE_FILTER_BILINEAR : GE_FILTER_NEAREST;
+}
+
+GE_TextureFilter GE_GetTextureFilter(GE_Context* ctx) {
+    return ctx ? ctx->texture_filter : GE_FILTER_NEAREST;
+}
 
-    int cols = anim->sprite->width / anim->frame_w;
-    if (cols == 0) cols = 1;
+// Puntero a la fila 'y' del cuadro lógico, o NULL si cae fuera de la zona almacenada
+static inline const unsigned char* GE_TexelRowOrNull(const GE_Sprite* s, int y) {
+    int ty = y - s->trim_y;
+    if ((unsigned)ty >= (unsigned)s->trim_h) return NULL;
+    return s->data + ty * s->pitch;
+}
 
-    // Calcular posición del frame en la textura
-    int col = anim->current_frame % cols;
-    int row = anim->current_frame / cols;
+// Texel empaquetado tal cual está en memoria (RGBA); 0 si es transparente por recorte
+static inline uint32_t GE_FetchTexel(const GE_Sprite* s, const unsigned char* row, int x) {
+    int tx = x - s->trim_x;
+    if (!row || (unsigned)tx >= (unsigned)s->trim_w) return 0;
+    if (s->palette) return s->palette->colors[row[tx]];
+    if (s->coverage) return 0x00FFFFFFu | ((uint32_t)row[tx] << 24); // Blanco con la cobertura de alpha
+    uint32_t v;
+    memcpy(&v, row + tx * 4, 4);
+    return v;
+}
 
-    GE_Rect src = {
-        (float)(col * anim->frame_w),
-        (float)(row * anim->frame_h),
-        (float)anim->frame_w,
-        (float)anim->frame_h
+// Un píxel completo en escalar: mismas operaciones enteras que el núcleo SIMD
+static inline void GE_BilinearResolveOne(GE_BilinearChunk* c, int i, bool premultiply) {
+    const unsigned char* q[4] = {
+        (const unsigned char*)&c->tl[i], (const unsigned char*)&c->tr[i],
+        (const unsigned char*)&c->bl[i], (const unsigned char*)&c->br[i]
     };
+    uint32_t fx = c->fx[i], fy = c->fy[i];
+    unsigned char* out = &c->out[i * 4];
+    for (int ch = 0; ch < 4; ch++) {
+        uint32_t v[4];
+        for (int k = 0; k < 4; k++) {
+            v[k] = q[k][ch];
+            if (premultiply && ch < 3) v[k] = (v[k] * q[k][3]) / 255;
+        }
+        uint32_t top = (v[0] * (256 - fx) + v[1] * fx) >> 8;
+        uint32_t bot = (v[2] * (256 - fx) + v[3] * fx) >> 8;
+        out[ch] = (unsigned char)((top * (256 - fy) + bot * fy) >> 8);
+    }
+}
 
-    GE_Rect dest = { x, y, (float)anim->frame_w, (float)anim->frame_h };
-    
-    // Si queremos invertir horizontalmente (Flip X)
-    // El truco en DrawSpriteEx sería pasar width negativo, pero nuestra implementación
-    // de DrawSpriteEx asume positivos. Para un flip real necesitaríamos ajustar los bucles.
-    // Por simplicidad, dibujamos normal por ahora.
-    
-    GE_DrawSpriteEx(ctx, anim->sprite, src, dest, tint);
+#ifdef GE_SIMD_SSE2
+// Expande 2 texels RGBA a 16 bits y, si hace falta, premultiplica RGB (alpha intacto)
+static inline __m128i GE_BilinearPrepare(__m128i px16, bool premultiply) {
+    if (!premultiply) return px16;
+    const __m128i alpha_lane = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(px16, 0xFF), 0xFF);
+    __m128i x = _mm_mullo_epi16(px16, a);
+    // x / 255 exacto: (x + 1 + (x >> 8)) >> 8
+    __m128i p = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+    return _mm_or_si128(_mm_andnot_si128(alpha_lane, p), _mm_and_si128(alpha_lane, px16));
 }
 
-//int GE_GetSpriteWidth(GE_Sprite* sprite) { return sprite ? sprite->width : 0; }
-//int GE_GetSpriteHeight(GE_Sprite* sprite) { return sprite ? sprite->height : 0; }
+// Interpola 2 píxeles (mitad baja o alta de los registros de 4 vecinos)
+static inline __m128i GE_BilinearLerp2(__m128i tl, __m128i tr, __m128i bl, __m128i br, __m128i fx, __m128i fy) {
+    const __m128i c256 = _mm_set1_epi16(256);
+    __m128i ifx = _mm_sub_epi16(c256, fx), ify = _mm_sub_epi16(c256, fy);
+    __m128i top = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(tl, ifx), _mm_mullo_epi16(tr, fx)), 8);
+    __m128i bot = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(bl, ifx), _mm_mullo_epi16(br, fx)), 8);
+    return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(top, ify), _mm_mullo_epi16(bot, fy)), 8);
+}
+#endif
 
-// ============================================================================
+// Paso 2: resuelve 'count' píxeles del tramo en c->out
+static void GE_BilinearResolve(GE_BilinearChunk* c, int count, bool premultiply) {
+    int i = 0;
+#ifdef GE_SIMD_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4) {
+        __m128i tl = _mm_loadu_si128((const __m128i*)(const void*)&c->tl[i]);
+        __m128i tr = _mm_loadu_si128((const __m128i*)(const void*)&c->tr[i]);
+        __m128i bl = _mm_loadu_si128((const __m128i*)(const void*)&c->bl[i]);
+        __m128i br = _mm_loadu_si128((const __m128i*)(const void*)&c->br[i]);
+        // Pesos repetidos en los 4 canales de cada píxel
+        __m128i fx_lo = _mm_set_epi16(c->fx[i+1], c->fx[i+1], c->fx[i+1], c->fx[i+1], c->fx[i], c->fx[i], c->fx[i], c->fx[i]);
+        __m128i fx_hi = _mm_set_epi16(c->fx[i+3], c->fx[i+3], c->fx[i+3], c->fx[i+3], c->fx[i+2], c->fx[i+2], c->fx[i+2], c->fx[i+2]);
+        __m128i fy_lo = _mm_set_epi16(c->fy[i+1], c->fy[i+1], c->fy[i+1], c->fy[i+1], c->fy[i], c->fy[i], c->fy[i], c->fy[i]);
+        __m128i fy_hi = _mm_set_epi16(c->fy[i+3], c->fy[i+3], c->fy[i+3], c->fy[i+3], c->fy[i+2], c->fy[i+2], c->fy[i+2], c->fy[i+2]);
+
+        __m128i lo = GE_BilinearLerp2(GE_BilinearPrepare(_mm_unpacklo_epi8(tl, zero), premultiply),
+                                      GE_BilinearPrepare(_mm_unpacklo_epi8(tr, zero), premultiply),
+                                      GE_BilinearPrepare(_mm_unpacklo_epi8(bl, zero), premultiply),
+                                      GE_BilinearPrepare(_mm_unpacklo_epi8(br, zero), premultiply), fx_lo, fy_lo);
+        __m128i hi = GE_BilinearLerp2(GE_BilinearPrepare(_mm_unpackhi_epi8(tl, zero), premultiply),
+                                      GE_BilinearPrepare(_mm_unpackhi_epi8(tr, zero), premultiply),
+                                      GE_BilinearPrepare(_mm_unpackhi_epi8(bl, zero), premultiply),
+                                      GE_BilinearPrepare(_mm_unpackhi_epi8(br, zero), premultiply), fx_hi, fy_hi);
+        _mm_storeu_si128((__m128i*)(void*)&c->out[i * 4], _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; i < count; i++) GE_BilinearResolveOne(c, i, premultiply);
+}
+
+// Paso 3: mezcla el tramo resuelto (premultiplicado) con el modo activo
+static void GE_BlendFilteredSpan(uint32_t* dst, int count, const unsigned char* rgba, GE_BlendMode mode, const GE_Tint* tint) {
+    int tinted = tint->color != 0xFFFFFFFF ? 1 : 0;
+    int done = 0;
+#ifdef GE_SIMD_LANES
+    done = g_simd_span_table[mode][1][tinted](dst, count, rgba, tint);
+#endif
+    if (done < count) {
+        GE_SpanStep st = { done, 0, 1, 0, 1, 4, NULL };
+        g_span_table[mode][GE_SRC_PREMUL][0][tinted](dst + done, count - done, rgba, 0, &st, tint);
+    }
+}
+
+// Coordenada en punto fijo 24.8 -> vecinos (a, a+1) dentro de [lo, hi] y peso del segundo
+static inline void GE_FilterTaps(int fixed, int lo, int hi, int* a, int* b, uint16_t* w) {
+    int i = fixed >> 8; // Desplazamiento aritmético: redondea hacia -infinito
+    *w = (uint16_t)(fixed & 0xFF);
+    *a = i < lo ? lo : (i > hi ? hi : i);
+    *b = i + 1 < lo ? lo : (i + 1 > hi ? hi : i + 1);
+}
+
+// Zona de la pantalla donde pueden escribir los blitters de sprites
+static inline void GE_BlitBounds(const GE_Context* ctx, int* x0, int* y0, int* x1, int* y1) {
+    if (ctx->clip_enabled) {
+        *x0 = ctx->clip_x0; *y0 = ctx->clip_y0; *x1 = ctx->clip_x1; *y1 = ctx->clip_y1;
+    } else {
+        *x0 = 0; *y0 = 0; *x1 = ctx->render_width; *y1 = ctx->render_height;
+    }
+}
+
+// Dibujo escalado alineado a ejes con filtro bilineal. Muestrea en el centro de cada
+// píxel destino: u = (dx + 0.5) * src_w / dest_w - 0.5 (recortado al rect fuente).
+static void GE_BlitSpriteBilinear(GE_Context* ctx, GE_Sprite* sprite, int src_x, int src_y, int src_w, int src_h,
+                                  int dest_x, int dest_y, int dest_w, int dest_h, int flip, const GE_Tint* tint) {
+    if (src_w <= 0 || src_h <= 0 || dest_w <= 0 || dest_h <= 0) return;
+
+    int bx0, by0, bx1, by1;
+    GE_BlitBounds(ctx, &bx0, &by0, &bx1, &by1);
+    int dx0 = bx0 - dest_x > 0 ? bx0 - dest_x : 0;
+    int dy0 = by0 - dest_y > 0 ? by0 - dest_y : 0;
+    int dx1 = bx1 - dest_x;
+    int dy1 = by1 - dest_y;
+    if (dx1 > dest_w) dx1 = dest_w;
+    if (dy1 > dest_h) dy1 = dest_h;
+    if (dx0 >= dx1 || dy0 >= dy1) return;
+
+    // Vecinos válidos: rect fuente recortado al cuadro lógico del sprite
+    int cx0 = src_x < 0 ? 0 : src_x, cy0 = src_y < 0 ? 0 : src_y;
+    int cx1 = src_x + src_w - 1, cy1 = src_y + src_h - 1;
+    if (cx1 >= sprite->width) cx1 = sprite->width - 1;
+    if (cy1 >= sprite->height) cy1 = sprite->height - 1;
+    if (cx0 > cx1 || cy0 > cy1) return;
+
+    // Paso en 24.8 por píxel destino (64 bits: no desborda con texturas grandes)
+    int64_t step_x = ((int64_t)src_w << 8) * 256 / dest_w;
+    int64_t step_y = ((int64_t)src_h << 8) * 256 / dest_h;
+    bool flip_x = (flip & GE_FLIP_X) != 0;
+    bool flip_y = (flip & GE_FLIP_Y) != 0;
+    bool premultiply = !GE_SpriteDataPremultiplied(sprite) && !GE_SpriteIsOpaque(sprite);
+    GE_BlendMode mode = ctx->blend_mode;
+    GE_BilinearChunk chunk;
+
+    for (int dy = dy0; dy < dy1; dy++) {
+        // Centro del píxel en 16.16 y luego a 24.8 (misma fórmula para X)
+        int64_t v = ((int64_t)dy * step_y + step_y / 2 - 32768) >> 8;
+        if (flip_y) v = ((int64_t)(src_h - 1) << 8) - v;
+        int y0, y1;
+        uint16_t fy;
+        GE_FilterTaps((int)v + (src_y << 8), cy0, cy1, &y0, &y1, &fy);
+        const unsigned char* row0 = GE_TexelRowOrNull(sprite, y0);
+        const unsigned char* row1 = GE_TexelRowOrNull(sprite, y1);
+        uint32_t* dst_row = &ctx->render_buffer[(dest_y + dy) * ctx->render_width + dest_x];
+
+        for (int start = dx0; start < dx1; start += GE_FILTER_CHUNK) {
+            int n = dx1 - start < GE_FILTER_CHUNK ? dx1 - start : GE_FILTER_CHUNK;
+            for (int k = 0; k < n; k++) {
+                int64_t u = ((int64_t)(start + k) * step_x + step_x / 2 - 32768) >> 8;
+                if (flip_x) u = ((int64_t)(src_w - 1) << 8) - u;
+                int x0, x1;
+                GE_FilterTaps((int)u + (src_x << 8), cx0, cx1, &x0, &x1, &chunk.fx[k]);
+                chunk.fy[k] = fy;
+                chunk.tl[k] = GE_FetchTexel(sprite, row0, x0);
+                chunk.tr[k] = GE_FetchTexel(sprite, row0, x1);
+                chunk.bl[k] = GE_FetchTexel(sprite, row1, x0);
+                chunk.br[k] = GE_FetchTexel(sprite, row1, x1);
+            }
+            GE_BilinearResolve(&chunk, n, premultiply);
+            GE_BlendFilteredSpan(&dst_row[start], n, chunk.out, mode, tint);
+        }
+    }
+}
+
+// --- MIPMAPS ---
+// Cadena de versiones reducidas a la mitad (filtro de caja 2x2). Al dibujar un sprite
+// muy reducido se muestrea el nivel cuya escala está más cerca de la reducción pedida:
+// menos aliasing y se leen muchos menos bytes por fila.
+
+// Lee un texel del cuadro lógico (transparente fuera de la zona almacenada)
+static inline const unsigned char* GE_SpriteTexelOrNull(const GE_Sprite* s, int x, int y) {
+    int tx = x - s->trim_x, ty = y - s->trim_y;
+    if ((unsigned)tx >= (unsigned)s->trim_w || (unsigned)ty >= (unsigned)s->trim_h) return NULL;
+    return GE_TexelAddress(s, tx, ty);
+}
+
+// Reduce a la mitad con un filtro de caja. Se promedia con alpha premultiplicado para
+// que el color de los píxeles transparentes no "sangre" en los bordes.
+static GE_Sprite* GE_DownsampleSprite(const GE_Sprite* src) {
+    int w = src->width / 2, h = src->height / 2;
+    if (w < 1) w = 1;
+    if (h < 1) h = 1;
+
+    unsigned char* data = (unsigned char*)malloc((size_t)w * h * 4);
+    GE_Sprite* dst = (GE_Sprite*)calloc(1, sizeof(GE_Sprite));
+    if (!data || !dst) { free(data); free(dst); return NULL; }
+    GE_InitSpriteFull(dst, w, h, data, true);
+    dst->premultiplied = GE_SpriteDataPremultiplied(src);
+
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            uint32_t sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
+            for (int k = 0; k < 4; k++) {
+                const unsigned char* px = GE_SpriteTexelOrNull(src, x * 2 + (k & 1), y * 2 + (k >> 1));
+                if (!px) continue;
+                uint32_t weight = dst->premultiplied ? 1 : px[3]; // Ya premultiplicado: suma directa
+                sum_r += px[0] * weight;
+                sum_g += px[1] * weight;
+                sum_b += px[2] * weight;
+                sum_a += px[3];
+            }
+            unsigned char* out = &data[(y * w + x) * 4];
+            if (dst->premultiplied) {
+                out[0] = (unsigned char)((sum_r + 2) / 4);
+                out[1] = (unsigned char)((sum_g + 2) / 4);
+                out[2] = (unsigned char)((sum_b + 2) / 4);
+            } else {
+                out[0] = sum_a ? (unsigned char)(sum_r / sum_a) : 0;
+                out[1] = sum_a ? (unsigned char)(sum_g / sum_a) : 0;
+                out[2] = sum_a ? (unsigned char)(sum_b / sum_a) : 0;
+            }
+            out[3] = (unsigned char)((sum_a + 2) / 4);
+        }
+    }
+    GE_DetectOpaque(dst);
+    return dst;
+}
+
+static void GE_FreeMipmaps(GE_Sprite* sprite) {
+    for (int i = 0; i < sprite->mip_count; i++) {
+        free(sprite->mips[i]->data);
+        free(sprite->mips[i]);
+    }
+    free(sprite->mips);
+    sprite->mips = NULL;
+    sprite->mip_count = 0;
+}
+
+static bool GE_BuildMipmaps(GE_Sprite* sprite) {
+    if (sprite->mip_count > 0) return true;
+
+    // Niveles hasta 1x1
+    int levels = 0;
+    for (int w = sprite->width, h = sprite->height; w > 1 || h > 1; w /= 2, h /= 2) levels++;
+    if (levels == 0) return true;
+
+    sprite->mips = (GE_Sprite**)calloc(levels, sizeof(GE_Sprite*));
+    if (!sprite->mips) return false;
+
+    const GE_Sprite* prev = sprite;
+    for (int i = 0; i < levels; i++) {
+        sprite->mips[i] = GE_DownsampleSprite(prev);
+        if (!sprite->mips[i]) {
+            GE_FreeMipmaps(sprite);
+            return false;
+        }
+        sprite->mip_count++;
+        prev = sprite->mips[i];
+    }
+    return true;
+}
+
+bool GE_EnableSpriteMipmaps(GE_Sprite* sprite, bool build_now) {
+    if (!sprite || !sprite->data) return false;
+    if (sprite->palette || sprite->coverage) return false; // Los niveles RGBA no seguirían los cambios de paleta
+    sprite->mips_enabled = true;
+    return build_now ? GE_BuildMipmaps(sprite) : true;
+}
+
+// Si el dibujo reduce el sprite, cambia al nivel más cercano a la escala pedida y
+// convierte el rect fuente a las coordenadas de ese nivel.
+static GE_Sprite* GE_SelectMipLevel(GE_Sprite* sprite, int* src_x, int* src_y, int* src_w, int* src_h, int dest_w, int dest_h) {
+    if (!sprite->mips_enabled || dest_w <= 0 || dest_h <= 0) return sprite;
+
+    // Usamos el eje menos reducido para no perder más detalle del necesario
+    float scale_x = (float)*src_w / dest_w;
+    float scale_y = (float)*src_h / dest_h;
+    float scale = scale_x < scale_y ? scale_x : scale_y;
+    if (scale < 1.41421356f) return sprite; // El nivel más cercano es el original
+
+    if (sprite->mip_count == 0 && !GE_BuildMipmaps(sprite)) return sprite;
+
+    int level = (int)floorf(log2f(scale) + 0.5f);
+    if (level > sprite->mip_count) level = sprite->mip_count;
+    if (level < 1) return sprite; // Sin niveles (sprite de 1x1): se dibuja el original
+
+    *src_x >>= level;
+    *src_y >>= level;
+    *src_w >>= level;
+    *src_h >>= level;
+    if (*src_w < 1) *src_w = 1;
+    if (*src_h < 1) *src_h = 1;
+    return sprite->mips[level - 1];
+}
+
+GE_Sprite* GE_LoadSprite(const char* filepath) {
+    GE_Sprite* spr = (GE_Sprite*)calloc(1, sizeof(GE_Sprite));
+    if (!spr) return NULL;
+
+    // Forzamos 4 canales (RGBA) para facilitar el dibujo
+    int w, h, channels;
+    unsigned char* data = stbi_load(filepath, &w, &h, &channels, 4);
+    
+    if (!data) {
+        printf("[GE] Error cargando sprite: %s\n", filepath);
+        free(spr);
+        return NULL;
+    }
+    
+    GE_InitSpriteFull(spr, w, h, data, true);
+    GE_DetectOpaque(spr);
+    return spr;
+}
+
+// --- SPRITES INDEXADOS (8 BPP) ---
+// Para arte retro con 256 colores o menos: un byte por texel (la cuarta parte de memoria
+// y de ancho de banda) más una paleta de 256 entradas. Los blitters expanden el índice
+// con la paleta al vuelo, así que cambiar la paleta (colores de equipo, destellos de daño)
+// cuesta O(256) en vez de retintar cada píxel.
+// Los texels totalmente transparentes se normalizan a un único color (0,0,0,0).
+
+static inline uint32_t GE_PackTexel(unsigned char r, unsigned char g, unsigned char b, unsigned char a) {
+    unsigned char px[4] = { r, g, b, a };
+    uint32_t v;
+    memcpy(&v, px, 4);
+    return v;
+}
+
+static inline uint32_t GE_ColorToTexel(GE_Color c) {
+    return GE_PackTexel((c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF, (c >> 24) & 0xFF);
+}
+
+static inline GE_Color GE_TexelToColor(uint32_t texel) {
+    const unsigned char* px = (const unsigned char*)&texel;
+    return ((GE_Color)px[3] << 24) | ((GE_Color)px[0] << 16) | ((GE_Color)px[1] << 8) | px[2];
+}
+
+// Recalcula la opacidad y renueva la versión tras modificar la paleta
+static void GE_PaletteChanged(GE_Palette* pal) {
+    pal->opaque = true;
+    for (int i = 0; i < pal->count; i++) {
+        if (((const unsigned char*)&pal->colors[i])[3] != 255) {
+            pal->opaque = false;
+            break;
+        }
+    }
+    pal->serial = GE_NextSpriteSerial();
+}
+
+// Cobertura A8: 'coverage' es un byte por texel con filas contiguas
+static void GE_InitSpriteCoverage(GE_Sprite* spr, int width, int height, unsigned char* coverage) {
+    GE_InitSpriteFull(spr, width, height, coverage, true);
+    spr->channels = 1;
+    spr->pitch = width;
+    spr->coverage = true;
+}
+
+static void GE_InitSpriteIndexed(GE_Sprite* spr, int width, int height, unsigned char* indices, GE_Palette* palette) {
+    GE_InitSpriteFull(spr, width, height, indices, true);
+    spr->channels = 1;
+    spr->pitch = width;
+    spr->palette = palette;
+    spr->owns_palette = true;
+    GE_PaletteChanged(palette);
+}
+
+// Texel de la imagen fuente con la transparencia total normalizada
+static inline uint32_t GE_QuantTexel(const unsigned char* px) {
+    return px[3] ? GE_PackTexel(px[0], px[1], px[2], px[3]) : 0;
+}
+
+// Caso sin pérdida (imágenes ya paletizadas): hasta 256 colores distintos.
+// Tabla hash abierta; retorna false en cuanto aparece el color 257.
+#define GE_EXACT_PALETTE_SLOTS 1024
+
+static bool GE_PaletteExact(const unsigned char* rgba, size_t n, unsigned char* indices, GE_Palette* pal) {
+    uint32_t keys[GE_EXACT_PALETTE_SLOTS];
+    int slots[GE_EXACT_PALETTE_SLOTS];
+    for (int i = 0; i < GE_EXACT_PALETTE_SLOTS; i++) slots[i] = -1;
+
+    pal->count = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint32_t c = GE_QuantTexel(&rgba[i * 4]);
+        uint32_t h = (c * 2654435761u) >> 22; // 10 bits
+        while (slots[h] >= 0 && keys[h] != c) h = (h + 1) & (GE_EXACT_PALETTE_SLOTS - 1);
+        if (slots[h] < 0) {
+            if (pal->count == 256) return false;
+            keys[h] = c;
+            slots[h] = pal->count;
+            pal->colors[pal->count++] = c;
+        }
+        indices[i] = (unsigned char)slots[h];
+    }
+    return true;
+}
+
+// Caso con pérdida: corte por la mediana sobre un histograma de 18 bits
+// (RGB a 5 bits, alpha a 3). Cada caja final es una entrada de la paleta con el color
+// medio real de sus píxeles. Si hay transparencia total se reserva el índice 0.
+#define GE_QUANT_KEY(px) (((uint32_t)(px)[0] >> 3) << 13 | ((uint32_t)(px)[1] >> 3) << 8 | \
+                          ((uint32_t)(px)[2] >> 3) << 3 | ((uint32_t)(px)[3] >> 5))
+
+typedef struct {
+    uint32_t key;
+    uint32_t count;
+    uint64_t sum[4];
+    unsigned char mean[4]; // Para ordenar y medir las cajas
+} GE_QuantBin;
+
+typedef struct {
+    int begin, end;  // Rango de bins
+    int channel;     // Canal de mayor extensión
+    int range;       // Su extensión (0 -> no se puede partir)
+} GE_QuantBox;
+
+#define GE_DEFINE_QUANT_COMPARE(CH) \
+static int GE_CompareQuantBins##CH(const void* a, const void* b) { \
+    return (int)((const GE_QuantBin*)a)->mean[CH] - (int)((const GE_QuantBin*)b)->mean[CH]; \
+}
+GE_DEFINE_QUANT_COMPARE(0)
+GE_DEFINE_QUANT_COMPARE(1)
+GE_DEFINE_QUANT_COMPARE(2)
+GE_DEFINE_QUANT_COMPARE(3)
+
+static int (* const g_quant_compare[4])(const void*, const void*) = {
+    GE_CompareQuantBins0, GE_CompareQuantBins1, GE_CompareQuantBins2, GE_CompareQuantBins3
+};
+
+static void GE_MeasureQuantBox(const GE_QuantBin* bins, GE_QuantBox* box) {
+    int lo[4] = { 255, 255, 255, 255 }, hi[4] = { 0, 0, 0, 0 };
+    for (int i = box->begin; i < box->end; i++) {
+        for (int ch = 0; ch < 4; ch++) {
+            if (bins[i].mean[ch] < lo[ch]) lo[ch] = bins[i].mean[ch];
+            if (bins[i].mean[ch] > hi[ch]) hi[ch] = bins[i].mean[ch];
+        }
+    }
+    box->channel = 0;
+    box->range = 0;
+    if (box->end - box->begin < 2) return;
+    for (int ch = 0; ch < 4; ch++) {
+        if (hi[ch] - lo[ch] > box->range) {
+            box->range = hi[ch] - lo[ch];
+            box->channel = ch;
+        }
+    }
+}
+
+static bool GE_PaletteMedianCut(const unsigned char* rgba, size_t n, unsigned char* indices, GE_Palette* pal) {
+    // map: clave -> bin + 1 durante el recuento, y después clave -> índice de paleta
+    uint32_t* map = (uint32_t*)calloc((size_t)1 << 18, sizeof(uint32_t));
+    if (!map) return false;
+
+    bool has_clear = false;
+    int bin_count = 0;
+    for (size_t i = 0; i < n; i++) {
+        const unsigned char* px = &rgba[i * 4];
+        if (px[3] == 0) { has_clear = true; continue; }
+        uint32_t key = GE_QUANT_KEY(px);
+        if (!map[key]) map[key] = ++bin_count;
+    }
+
+    GE_QuantBin* bins = (GE_QuantBin*)calloc(bin_count ? bin_count : 1, sizeof(GE_QuantBin));
+    if (!bins) { free(map); return false; }
+    for (size_t i = 0; i < n; i++) {
+        const unsigned char* px = &rgba[i * 4];
+        if (px[3] == 0) continue;
+        uint32_t key = GE_QUANT_KEY(px);
+        GE_QuantBin* bin = &bins[map[key] - 1];
+        bin->key = key;
+        bin->count++;
+        for (int ch = 0; ch < 4; ch++) bin->sum[ch] += px[ch];
+    }
+    for (int i = 0; i < bin_count; i++) {
+        for (int ch = 0; ch < 4; ch++) bins[i].mean[ch] = (unsigned char)(bins[i].sum[ch] / bins[i].count);
+    }
+
+    // Partir siempre la caja más extensa por la mediana ponderada de su canal dominante
+    int first = has_clear ? 1 : 0;
+    int max_boxes = 256 - first;
+    GE_QuantBox boxes[256];
+    int box_count = 0;
+    if (bin_count > 0) {
+        boxes[0].begin = 0;
+        boxes[0].end = bin_count;
+        GE_MeasureQuantBox(bins, &boxes[0]);
+        box_count = 1;
+    }
+    while (box_count < max_boxes) {
+        int best = -1;
+        for (int i = 0; i < box_count; i++) {
+            if (boxes[i].range > 0 && (best < 0 || boxes[i].range > boxes[best].range)) best = i;
+        }
+        if (best < 0) break;
+
+        GE_QuantBox* box = &boxes[best];
+        qsort(&bins[box->begin], box->end - box->begin, sizeof(GE_QuantBin), g_quant_compare[box->channel]);
+        uint64_t total = 0, acc = 0;
+        for (int i = box->begin; i < box->end; i++) total += bins[i].count;
+        int split = box->begin + 1;
+        for (int i = box->begin; i < box->end - 1; i++) {
+            acc += bins[i].count;
+            split = i + 1;
+            if (acc * 2 >= total) break;
+        }
+
+        GE_QuantBox* other = &boxes[box_count++];
+        other->begin = split;
+        other->end = box->end;
+        box->end = split;
+        GE_MeasureQuantBox(bins, box);
+        GE_MeasureQuantBox(bins, other);
+    }
+
+    // Color medio de cada caja y tabla clave -> índice
+    pal->count = first + box_count;
+    if (has_clear) pal->colors[0] = 0;
+    for (int b = 0; b < box_count; b++) {
+        uint64_t sum[4] = { 0, 0, 0, 0 }, count = 0;
+        for (int i = boxes[b].begin; i < boxes[b].end; i++) {
+            for (int ch = 0; ch < 4; ch++) sum[ch] += bins[i].sum[ch];
+            count += bins[i].count;
+            map[bins[i].key] = (uint32_t)(first + b);
+        }
+        pal->colors[first + b] = GE_PackTexel((unsigned char)(sum[0] / count), (unsigned char)(sum[1] / count),
+                                              (unsigned char)(sum[2] / count), (unsigned char)(sum[3] / count));
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        const unsigned char* px = &rgba[i * 4];
+        indices[i] = px[3] ? (unsigned char)map[GE_QUANT_KEY(px)] : 0;
+    }
+
+    free(bins);
+    free(map);
+    return true;
+}
+
+GE_Sprite* GE_LoadSpriteIndexed(const char* filepath) {
+    int w, h, channels;
+    unsigned char* rgba = stbi_load(filepath, &w, &h, &channels, 4);
+    if (!rgba) {
+        printf("[GE] Error cargando sprite: %s\n", filepath);
+        return NULL;
+    }
+
+    size_t n = (size_t)w * h;
+    unsigned char* indices = (unsigned char*)malloc(n);
+    GE_Palette* pal = (GE_Palette*)calloc(1, sizeof(GE_Palette));
+    GE_Sprite* spr = (GE_Sprite*)calloc(1, sizeof(GE_Sprite));
+    if (!indices || !pal || !spr ||
+        (!GE_PaletteExact(rgba, n, indices, pal) && !GE_PaletteMedianCut(rgba, n, indices, pal))) {
+        printf("[GE] Error: Sin memoria para el sprite indexado: %s\n", filepath);
+        stbi_image_free(rgba);
+        free(indices);
+        free(pal);
+        free(spr);
+        return NULL;
+    }
+    stbi_image_free(rgba);
+
+    GE_InitSpriteIndexed(spr, w, h, indices, pal);
+    return spr;
+}
+
+GE_Sprite* GE_CreateSpriteIndexed(int width, int height, const unsigned char* indices, const GE_Color* palette, int color_count) {
+    if (width <= 0 || height <= 0 || !indices || !palette || color_count <= 0 || color_count > 256) return NULL;
+
+    unsigned char* data = (unsigned char*)malloc((size_t)width * height);
+    GE_Palette* pal = (GE_Palette*)calloc(1, sizeof(GE_Palette));
+    GE_Sprite* spr = (GE_Sprite*)calloc(1, sizeof(GE_Sprite));
+    if (!data || !pal || !spr) {
+        free(data);
+        free(pal);
+        free(spr);
+        return NULL;
+    }
+    memcpy(data, indices, (size_t)width * height);
+
+    // Las entradas sin definir quedan transparentes (índices fuera de rango no pintan)
+    for (int i = 0; i < color_count; i++) pal->colors[i] = GE_ColorToTexel(palette[i]);
+    pal->count = color_count;
+
+    GE_InitSpriteIndexed(spr, width, height, data, pal);
+    return spr;
+}
+
+bool GE_SetSpritePalette(GE_Sprite* sprite, int first, const GE_Color* colors, int count) {
+    if (!sprite || !sprite->palette || !colors || first < 0 || count <= 0 || first + count > 256) return false;
+
+    // Un sub-sprite que aún comparte la paleta del padre recibe su propia copia
+    if (!sprite->owns_palette) {
+        GE_Palette* own = (GE_Palette*)malloc(sizeof(GE_Palette));
+        if (!own) return false;
+        memcpy(own, sprite->palette, sizeof(GE_Palette));
+        sprite->palette = own;
+        sprite->owns_palette = true;
+    }
+
+    GE_Palette* pal = sprite->palette;
+    for (int i = 0; i < count; i++) pal->colors[first + i] = GE_ColorToTexel(colors[i]);
+    if (first + count > pal->count) pal->count = first + count;
+    GE_PaletteChanged(pal);
+    return true;
+}
+
+int GE_GetSpritePalette(GE_Sprite* sprite, GE_Color* out, int max_colors) {
+    if (!sprite || !sprite->palette) return 0;
+    int count = sprite->palette->count;
+    if (out) {
+        for (int i = 0; i < count && i < max_colors; i++) out[i] = GE_TexelToColor(sprite->palette->colors[i]);
+    }
+    return count;
+}
+
+// --- MÁSCARAS DE COLISIÓN ---
+// Colisión píxel a píxel sin tocar los texels: la máscara empaqueta 64 píxeles por palabra,
+// así que comparar dos filas es un AND (más un desplazamiento para alinear) cada 64 columnas.
+// Solo se recorren las filas donde se cruzan las cajas de bits a 1 de ambos sprites.
+
+static void GE_FreeSpriteMask(GE_Sprite* sprite) {
+    if (!sprite->mask) return;
+    free(sprite->mask->bits);
+    free(sprite->mask);
+    sprite->mask = NULL;
+}
+
+bool GE_BuildSpriteMask(GE_Sprite* sprite, unsigned char alpha_threshold) {
+    if (!sprite || sprite->width <= 0 || sprite->height <= 0) return false;
+    if (alpha_threshold == 0) alpha_threshold = 1; // Alpha 0 nunca colisiona
+
+    int words = (sprite->width + 63) / 64;
+    GE_CollisionMask* mask = (GE_CollisionMask*)calloc(1, sizeof(GE_CollisionMask));
+    uint64_t* bits = (uint64_t*)calloc((size_t)words * sprite->height, sizeof(uint64_t));
+    if (!mask || !bits) {
+        printf("[GE] Error: Sin memoria para la mascara de colision\n");
+        free(mask);
+        free(bits);
+        return false;
+    }
+    mask->bits = bits;
+    mask->words_per_row = words;
+    mask->x0 = sprite->width;
+    mask->y0 = sprite->height;
+
+    // Fuera de la zona almacenada todo es transparente: los bits ya están a 0
+    for (int ty = 0; sprite->data && ty < sprite->trim_h; ty++) {
+        int y = sprite->trim_y + ty;
+        uint64_t* row = bits + (size_t)y * words;
+        for (int tx = 0; tx < sprite->trim_w; tx++) {
+            if (GE_TexelAddress(sprite, tx, ty)[3] < alpha_threshold) continue;
+            int x = sprite->trim_x + tx;
+            row[x >> 6] |= (uint64_t)1 << (x & 63);
+            if (x < mask->x0) mask->x0 = x;
+            if (x >= mask->x1) mask->x1 = x + 1;
+            if (y < mask->y0) mask->y0 = y;
+            mask->y1 = y + 1;
+        }
+    }
+
+    GE_FreeSpriteMask(sprite);
+    sprite->mask = mask;
+    return true;
+}
+
+// 64 bits de la fila a partir de la columna 'bit' (los que pasan del ancho son 0)
+static inline uint64_t GE_MaskBits64(const uint64_t* row, int words, int bit) {
+    int w = bit >> 6, sh = bit & 63;
+    uint64_t v = row[w] >> sh;
+    if (sh && w + 1 < words) v |= row[w + 1] << (64 - sh);
+    return v;
+}
+
+bool GE_SpriteOverlap(GE_Sprite* a, GE_Point pos_a, GE_Sprite* b, GE_Point pos_b) {
+    if (!a || !b) return false;
+    if (!a->mask && !GE_BuildSpriteMask(a, 1)) return false;
+    if (!b->mask && !GE_BuildSpriteMask(b, 1)) return false;
+
+    const GE_CollisionMask* ma = a->mask;
+    const GE_CollisionMask* mb = b->mask;
+    int ax = (int)floorf(pos_a.x), ay = (int)floorf(pos_a.y);
+    int bx = (int)floorf(pos_b.x), by = (int)floorf(pos_b.y);
+
+    // Intersección de las cajas de bits a 1, en coordenadas de mundo
+    int x0 = ax + ma->x0 > bx + mb->x0 ? ax + ma->x0 : bx + mb->x0;
+    int y0 = ay + ma->y0 > by + mb->y0 ? ay + ma->y0 : by + mb->y0;
+    int x1 = ax + ma->x1 < bx + mb->x1 ? ax + ma->x1 : bx + mb->x1;
+    int y1 = ay + ma->y1 < by + mb->y1 ? ay + ma->y1 : by + mb->y1;
+    if (x0 >= x1 || y0 >= y1) return false;
+
+    int n = x1 - x0;
+    int bit_a = x0 - ax, bit_b = x0 - bx;
+    for (int y = y0; y < y1; y++) {
+        const uint64_t* row_a = ma->bits + (size_t)(y - ay) * ma->words_per_row;
+        const uint64_t* row_b = mb->bits + (size_t)(y - by) * mb->words_per_row;
+        for (int k = 0; k < n; k += 64) {
+            uint64_t hit = GE_MaskBits64(row_a, ma->words_per_row, bit_a + k) &
+                           GE_MaskBits64(row_b, mb->words_per_row, bit_b + k);
+            if (n - k < 64) hit &= ((uint64_t)1 << (n - k)) - 1;
+            if (hit) return true;
+        }
+    }
+    return false;
+}
+
+// Convierte los píxeles a alpha premultiplicado (se mezclan con una multiplicación menos).
+// No se permite en sub-sprites: sus píxeles son del padre (las vistas leen el formato del dueño).
+bool GE_PremultiplySprite(GE_Sprite* sprite) {
+    if (!sprite || !sprite->data) return false;
+    if (sprite->palette) return false; // La paleta se guarda siempre en alpha recto
+    if (sprite->premultiplied) return true;
+    if (!sprite->owns_data && !sprite->atlas_owned) return false;
+
+    for (int y = 0; y < sprite->trim_h; y++) {
+        unsigned char* row = sprite->data + y * sprite->pitch;
+        for (int x = 0; x < sprite->trim_w; x++) {
+            unsigned char* px = &row[x * 4];
+            px[0] = (unsigned char)((px[0] * px[3] + 127) / 255);
+            px[1] = (unsigned char)((px[1] * px[3] + 127) / 255);
+            px[2] = (unsigned char)((px[2] * px[3] + 127) / 255);
+        }
+    }
+    sprite->premultiplied = true;
+    GE_FreeMipmaps(sprite); // Se regeneran al próximo dibujo reducido
+    return true;
+}
+
+void GE_UnloadSprite(GE_Sprite* sprite) {
+    if (sprite) {
+        if (sprite->atlas_owned) return; // Lo libera GE_UnloadAtlas
+        GE_FreeMipmaps(sprite);
+        GE_FreeSpriteMask(sprite);
+        if (sprite->owns_data && sprite->data) stbi_image_free(sprite->data);
+        if (sprite->owns_palette) free(sprite->palette);
+        free(sprite);
+    }
+}
+
+int GE_GetSpriteWidth(GE_Sprite* sprite) {
+    return sprite ? sprite->width : 0;
+}
+
+int GE_GetSpriteHeight(GE_Sprite* sprite) {
+    return sprite ? sprite->height : 0;
+}
+
+void GE_DrawSprite(GE_Context* ctx, GE_Sprite* sprite, float x, float y, GE_Color tint) {
+    if (!sprite || !sprite->data) return;
+    
+    // Usamos DrawSpriteEx para no repetir código, asumiendo rect completo
+    GE_Rect src = { 0, 0, (float)sprite->width, (float)sprite->height };
+    GE_Rect dst = { x, y, (float)sprite->width, (float)sprite->height };
+    GE_DrawSpriteEx(ctx, sprite, src, dst, tint);
+}
+
+// Rango [d0, d1) de píxeles destino (de 0..dest_n) cuyo índice fuente
+// m = (d * src_n) / dest_n cae en [m0, m1). El texel m se alcanza desde d = ceil(m * dest_n / src_n).
+static inline void GE_DestRangeForTexels(int m0, int m1, int src_n, int dest_n, int* d0, int* d1) {
+    *d0 = (m0 * dest_n + src_n - 1) / src_n;
+    *d1 = (m1 * dest_n + src_n - 1) / src_n;
+}
+
+// Núcleo de dibujado escalado (Nearest Neighbor). El recorte contra la pantalla se
+// resuelve UNA vez como rango de filas/columnas y la columna fuente avanza con un
+// acumulador entero (sin divisiones ni comprobaciones de límites por píxel).
+// El espejo (flip) solo invierte la dirección de muestreo: no hace falta otra imagen.
+static void GE_BlitSpriteRegionNow(GE_Context* ctx, GE_Sprite* sprite, int src_x, int src_y, int src_w, int src_h,
+                                   int dest_x, int dest_y, int dest_w, int dest_h, int flip, const GE_Tint* tint) {
+    if (src_w <= 0 || src_h <= 0 || dest_w <= 0 || dest_h <= 0) return;
+
+    // A escala 1:1 el bilineal muestrea justo en los centros: igual que el más cercano
+    if (ctx->texture_filter == GE_FILTER_BILINEAR && (src_w != dest_w || src_h != dest_h)) {
+        GE_BlitSpriteBilinear(ctx, sprite, src_x, src_y, src_w, src_h, dest_x, dest_y, dest_w, dest_h, flip, tint);
+        return;
+    }
+
+    // Rango visible dentro del rect destino
+    int bx0, by0, bx1, by1;
+    GE_BlitBounds(ctx, &bx0, &by0, &bx1, &by1);
+    int dx0 = bx0 - dest_x > 0 ? bx0 - dest_x : 0;
+    int dy0 = by0 - dest_y > 0 ? by0 - dest_y : 0;
+    int dx1 = bx1 - dest_x;
+    int dy1 = by1 - dest_y;
+    if (dx1 > dest_w) dx1 = dest_w;
+    if (dy1 > dest_h) dy1 = dest_h;
+
+    // Texels (relativos al rect fuente) que están dentro de la zona almacenada.
+    // Esto recorta los bordes transparentes del atlas y además protege lecturas fuera del sprite.
+    int kx0 = sprite->trim_x - src_x, kx1 = sprite->trim_x + sprite->trim_w - src_x;
+    int ky0 = sprite->trim_y - src_y, ky1 = sprite->trim_y + sprite->trim_h - src_y;
+    if (kx0 < 0) kx0 = 0;
+    if (ky0 < 0) ky0 = 0;
+    if (kx1 > src_w) kx1 = src_w;
+    if (ky1 > src_h) ky1 = src_h;
+    if (kx0 >= kx1 || ky0 >= ky1) return;
+
+    // Con espejo, el paso m del destino lee el texel (src_n - 1 - m)
+    bool flip_x = (flip & GE_FLIP_X) != 0;
+    bool flip_y = (flip & GE_FLIP_Y) != 0;
+    int tx0, tx1, ty0, ty1;
+    if (flip_x) GE_DestRangeForTexels(src_w - kx1, src_w - kx0, src_w, dest_w, &tx0, &tx1);
+    else        GE_DestRangeForTexels(kx0, kx1, src_w, dest_w, &tx0, &tx1);
+    if (flip_y) GE_DestRangeForTexels(src_h - ky1, src_h - ky0, src_h, dest_h, &ty0, &ty1);
+    else        GE_DestRangeForTexels(ky0, ky1, src_h, dest_h, &ty0, &ty1);
+    if (dx0 < tx0) dx0 = tx0;
+    if (dy0 < ty0) dy0 = ty0;
+    if (dx1 > tx1) dx1 = tx1;
+    if (dy1 > ty1) dy1 = ty1;
+    if (dx0 >= dx1 || dy0 >= dy1) return;
+
+    int step_int = src_w / dest_w;  // Paso entero de columna fuente por píxel
+    int step_rem = src_w % dest_w;  // Resto que se acumula
+    int col_start = (dx0 * src_w) / dest_w;
+    int rem_start = (dx0 * src_w) % dest_w;
+
+    // Dirección de lectura dentro de la fila (+bpp normal, -bpp espejado)
+    int bpp = GE_TexelBytes(sprite);
+    int col_dir  = flip_x ? -bpp : bpp;
+    int col_base = (src_x - sprite->trim_x + (flip_x ? src_w - 1 : 0)) * bpp;
+
+    bool scaled = src_w != dest_w;
+    GE_SpanStep st = { col_start, rem_start, step_int, step_rem, dest_w, col_dir,
+                       sprite->palette ? sprite->palette->colors : NULL };
+    GE_SpanFn span = GE_SelectSpan(sprite, ctx->blend_mode, scaled, tint);
+#ifdef GE_SIMD_LANES
+    GE_SimdSpanFn simd = (!scaled && !flip_x) ? GE_SelectSimdSpan(sprite, ctx->blend_mode, tint) : NULL;
+#endif
+    int count = dx1 - dx0;
+
+    for (int dy = dy0; dy < dy1; dy++) {
+        int sy = (dy * src_h) / dest_h;
+        if (flip_y) sy = src_h - 1 - sy;
+        int row_off = (src_y + sy - sprite->trim_y) * sprite->pitch + col_base;
+        uint32_t* dst = &ctx->render_buffer[(dest_y + dy) * ctx->render_width + dest_x + dx0];
+        int done = 0;
+#ifdef GE_SIMD_LANES
+        // Tramo múltiplo del ancho del vector en SIMD; la cola (si queda) en escalar
+        if (simd) done = simd(dst, count, sprite->data + row_off + col_start * bpp, tint);
+#endif
+        if (done == 0) {
+            span(dst, count, sprite->data, row_off, &st, tint);
+        } else if (done < count) {
+            GE_SpanStep tail = st;
+            tail.sx += done;
+            span(dst + done, count - done, sprite->data, row_off, &tail, tint);
+        }
+    }
+}
+
+// --- PASADA DIFERIDA DE SPRITES ---
+// Entre GE_BeginDeferredSprites y GE_EndDeferredSprites los dibujos de sprites alineados
+// a ejes (DrawSprite/Ex/Flipped, hojas, animaciones, lotes y la caché de transformaciones)
+// solo se graban. Al cerrar:
+//   1. Los opacos (sprite opaco, modo ALPHA/REPLACE, rect fuente sin bordes recortados)
+//      se pintan de delante hacia atrás contra un c-buffer: por cada fila, la lista de
+//      tramos ya cubiertos. Solo se pintan los huecos, y los huecos pasan a estar cubiertos.
+//   2. El resto, de atrás hacia delante y solo donde no los tapa un opaco grabado después.
+// El resultado es el mismo que dibujando en orden; cada píxel tapado se escribe una vez.
+
+// Asegura capacidad para 'needed' tramos
+static bool GE_ReserveCoverSpans(GE_CoverSpan** list, int* capacity, int needed) {
+    if (needed <= *capacity) return true;
+    int new_cap = *capacity ? *capacity : 8;
+    while (new_cap < needed) new_cap *= 2;
+    GE_CoverSpan* spans = (GE_CoverSpan*)realloc(*list, new_cap * sizeof(GE_CoverSpan));
+    if (!spans) return false;
+    *list = spans;
+    *capacity = new_cap;
+    return true;
+}
+
+// Partes de [a, b) en la fila 'y' no tapadas por opacos con índice > 'above' -> scratch.
+// Retorna cuántas hay (-1 sin memoria).
+static int GE_VisibleSpans(GE_DeferredPass* pass, int y, int a, int b, int above) {
+    const GE_CoverSpan* row = pass->rows[y];
+    int n = pass->row_count[y];
+    if (!GE_ReserveCoverSpans(&pass->scratch, &pass->scratch_capacity, n + 1)) return -1;
+
+    int out = 0, cursor = a;
+    for (int i = 0; i < n && cursor < b; i++) {
+        if (row[i].x1 <= cursor || row[i].index <= above) continue;
+        if (row[i].x0 >= b) break;
+        if (row[i].x0 > cursor) pass->scratch[out++] = (GE_CoverSpan){ cursor, row[i].x0, 0 };
+        cursor = row[i].x1;
+    }
+    if (cursor < b) pass->scratch[out++] = (GE_CoverSpan){ cursor, b, 0 };
+    return out;
+}
+
+// Marca como cubiertos los 'count' huecos de scratch (el comando opaco 'index' los pinta)
+static bool GE_CoverSpans(GE_DeferredPass* pass, int y, int count, int index) {
+    int n = pass->row_count[y];
+    if (!GE_ReserveCoverSpans(&pass->rows[y], &pass->row_capacity[y], n + count)) return false;
+
+    // Mezcla de dos listas ordenadas desde el final, en el sitio
+    GE_CoverSpan* row = pass->rows[y];
+    int i = n - 1, j = count - 1, k = n + count - 1;
+    while (j >= 0) {
+        if (i >= 0 && row[i].x0 > pass->scratch[j].x0) row[k--] = row[i--];
+        else {
+            row[k] = pass->scratch[j--];
+            row[k--].index = index;
+        }
+    }
+    pass->row_count[y] = n + count;
+    return true;
+}
+
+static bool GE_IsOccluder(const GE_DeferredCmd* cmd) {
+    const GE_Sprite* s = cmd->sprite;
+    if (cmd->mode != GE_BLEND_ALPHA && cmd->mode != GE_BLEND_REPLACE) return false;
+    if (!s->data || !GE_SpriteIsOpaque(s)) return false;
+    // Todo el rect fuente dentro de la zona almacenada: cubre el rect destino entero
+    return cmd->src_x >= s->trim_x && cmd->src_y >= s->trim_y &&
+           cmd->src_x + cmd->src_w <= s->trim_x + s->trim_w &&
+           cmd->src_y + cmd->src_h <= s->trim_y + s->trim_h;
+}
+
+// Pinta la parte [x0, x1) x [y0, y1) de un comando grabado
+static void GE_DrawDeferredPart(GE_Context* ctx, const GE_DeferredCmd* cmd, int x0, int y0, int x1, int y1) {
+    if (ctx->render_queue) {
+        // Con render multihilo la parte visible se encola con su zona como recorte
+        GE_DeferredCmd part = *cmd;
+        part.x0 = x0;
+        part.y0 = y0;
+        part.x1 = x1;
+        part.y1 = y1;
+        if (GE_RecordSprite(ctx, &part)) return;
+    }
+    ctx->clip_x0 = x0;
+    ctx->clip_y0 = y0;
+    ctx->clip_x1 = x1;
+    ctx->clip_y1 = y1;
+    ctx->blend_mode = cmd->mode;
+    ctx->texture_filter = cmd->filter;
+    GE_Tint t = GE_MakeTint(cmd->tint);
+    GE_BlitSpriteRegionNow(ctx, cmd->sprite, cmd->src_x, cmd->src_y, cmd->src_w, cmd->src_h,
+                           cmd->dest_x, cmd->dest_y, cmd->dest_w, cmd->dest_h, cmd->flip, &t);
+}
+
+// Recorre las filas del comando: las partes visibles se pintan y, si es opaco, se cubren.
+// Las filas consecutivas con un único tramo idéntico se agrupan en un solo blit.
+static bool GE_FlushDeferredCmd(GE_Context* ctx, GE_DeferredPass* pass, int index, bool occluder) {
+    const GE_DeferredCmd* cmd = &pass->cmds[index];
+    int run_x0 = 0, run_x1 = 0, run_y0 = 0, run_y1 = 0; // Bloque pendiente (vacío si run_y0 == run_y1)
+
+    for (int y = cmd->y0; y < cmd->y1; y++) {
+        int count = GE_VisibleSpans(pass, y, cmd->x0, cmd->x1, occluder ? -1 : index);
+        if (count < 0) return false;
+
+        uint64_t visible = 0;
+        for (int i = 0; i < count; i++) visible += pass->scratch[i].x1 - pass->scratch[i].x0;
+        pass->stats.pixels_drawn += visible;
+        pass->stats.pixels_occluded += (uint64_t)(cmd->x1 - cmd->x0) - visible;
+
+        if (count == 1 && run_y1 == y && run_y0 < run_y1 &&
+            pass->scratch[0].x0 == run_x0 && pass->scratch[0].x1 == run_x1) {
+            run_y1 = y + 1;
+        } else {
+            if (run_y0 < run_y1) GE_DrawDeferredPart(ctx, cmd, run_x0, run_y0, run_x1, run_y1);
+            run_y0 = run_y1 = 0;
+            if (count == 1) {
+                run_x0 = pass->scratch[0].x0;
+                run_x1 = pass->scratch[0].x1;
+                run_y0 = y;
+                run_y1 = y + 1;
+            } else {
+                for (int i = 0; i < count; i++) {
+                    GE_DrawDeferredPart(ctx, cmd, pass->scratch[i].x0, y, pass->scratch[i].x1, y + 1);
+                }
+            }
+        }
+        if (occluder && count > 0 && !GE_CoverSpans(pass, y, count, index)) return false;
+    }
+    if (run_y0 < run_y1) GE_DrawDeferredPart(ctx, cmd, run_x0, run_y0, run_x1, run_y1);
+    return true;
+}
+
+void GE_BeginDeferredSprites(GE_Context* ctx) {
+    if (!ctx) return;
+    if (!ctx->deferred) {
+        ctx->deferred = (GE_DeferredPass*)calloc(1, sizeof(GE_DeferredPass));
+        if (!ctx->deferred) {
+            printf("[GE] Error: Sin memoria para la pasada diferida\n");
+            return;
+        }
+    }
+    ctx->deferred->recording = true;
+    ctx->deferred->pass_id++;
+    ctx->deferred->count = 0;
+}
+
+void GE_EndDeferredSprites(GE_Context* ctx) {
+    if (!ctx || !ctx->deferred || !ctx->deferred->recording) return;
+    GE_DeferredPass* pass = ctx->deferred;
+    pass->recording = false;
+
+    // c-buffer vacío, una lista por fila del lienzo
+    if (pass->row_total != ctx->render_height) {
+        for (int y = 0; y < pass->row_total; y++) free(pass->rows[y]);
+        free(pass->rows);
+        free(pass->row_count);
+        free(pass->row_capacity);
+        pass->rows = (GE_CoverSpan**)calloc(ctx->render_height, sizeof(GE_CoverSpan*));
+        pass->row_count = (int*)calloc(ctx->render_height, sizeof(int));
+        pass->row_capacity = (int*)calloc(ctx->render_height, sizeof(int));
+        pass->row_total = ctx->render_height;
+    }
+    memset(&pass->stats, 0, sizeof(pass->stats));
+    pass->stats.commands = pass->count;
+
+    GE_BlendMode saved_mode = ctx->blend_mode;
+    GE_TextureFilter saved_filter = ctx->texture_filter;
+    ctx->clip_enabled = true;
+
+    bool ok = pass->rows && pass->row_count && pass->row_capacity;
+    if (ok) {
+        for (int y = 0; y < pass->row_total; y++) pass->row_count[y] = 0;
+
+        // 1. Opacos, de delante hacia atrás
+        for (int i = pass->count - 1; i >= 0 && ok; i--) {
+            if (!GE_IsOccluder(&pass->cmds[i])) continue;
+            pass->stats.opaque_commands++;
+            ok = GE_FlushDeferredCmd(ctx, pass, i, true);
+        }
+        // 2. Resto, de atrás hacia delante
+        for (int i = 0; i < pass->count && ok; i++) {
+            if (GE_IsOccluder(&pass->cmds[i])) continue;
+            ok = GE_FlushDeferredCmd(ctx, pass, i, false);
+        }
+    }
+    if (!ok) printf("[GE] Error: Sin memoria en la pasada diferida\n");
+
+    ctx->clip_enabled = false;
+    ctx->blend_mode = saved_mode;
+    ctx->texture_filter = saved_filter;
+    pass->count = 0;
+
+    // Lo dibujado puede seguir en la cola del render multihilo
+    if (pass->retired_count > 0) {
+        GE_FlushRendering(ctx);
+        for (int i = 0; i < pass->retired_count; i++) GE_FreeCachedImage(pass->retired[i]);
+        pass->retired_count = 0;
+    }
+}
+
+GE_DeferredStats GE_GetDeferredStats(GE_Context* ctx) {
+    GE_DeferredStats stats = { 0 };
+    if (ctx && ctx->deferred) stats = ctx->deferred->stats;
+    return stats;
+}
+
+// Punto de entrada de todos los dibujos de sprites alineados a ejes
+static void GE_BlitSpriteRegion(GE_Context* ctx, GE_Sprite* sprite, int src_x, int src_y, int src_w, int src_h,
+                                int dest_x, int dest_y, int dest_w, int dest_h, int flip, const GE_Tint* tint) {
+    GE_DeferredPass* pass = ctx->deferred;
+    bool recording = pass && pass->recording;
+    if (!recording && !ctx->render_queue) {
+        GE_BlitSpriteRegionNow(ctx, sprite, src_x, src_y, src_w, src_h, dest_x, dest_y, dest_w, dest_h, flip, tint);
+        return;
+    }
+    if (src_w <= 0 || src_h <= 0 || dest_w <= 0 || dest_h <= 0 || !sprite->data) return;
+
+    GE_DeferredCmd cmd = {
+        sprite, src_x, src_y, src_w, src_h, dest_x, dest_y, dest_w, dest_h, flip, tint->color,
+        ctx->blend_mode, ctx->texture_filter,
+        dest_x < 0 ? 0 : dest_x, dest_y < 0 ? 0 : dest_y,
+        dest_x + dest_w > ctx->render_width ? ctx->render_width : dest_x + dest_w,
+        dest_y + dest_h > ctx->render_height ? ctx->render_height : dest_y + dest_h
+    };
+    if (cmd.x0 >= cmd.x1 || cmd.y0 >= cmd.y1) return; // Fuera de pantalla: ni se graba
+
+    // Sin pasada diferida abierta: a la cola del render multihilo
+    if (!recording) {
+        if (!GE_RecordSprite(ctx, &cmd)) {
+            GE_BlitSpriteRegionNow(ctx, sprite, src_x, src_y, src_w, src_h, dest_x, dest_y, dest_w, dest_h, flip, tint);
+        }
+        return;
+    }
+
+    if (pass->count == pass->capacity) {
+        int new_cap = pass->capacity ? pass->capacity * 2 : 256;
+        GE_DeferredCmd* cmds = (GE_DeferredCmd*)realloc(pass->cmds, new_cap * sizeof(GE_DeferredCmd));
+        if (!cmds) {
+            // Sin memoria para grabar: se dibuja ya (el orden se mantiene respecto a lo inmediato)
+            if (!ctx->render_queue || !GE_RecordSprite(ctx, &cmd)) {
+                GE_BlitSpriteRegionNow(ctx, sprite, src_x, src_y, src_w, src_h, dest_x, dest_y, dest_w, dest_h, flip, tint);
+            }
+            return;
+        }
+        pass->cmds = cmds;
+        pass->capacity = new_cap;
+    }
+    pass->cmds[pass->count++] = cmd;
+}
+
+// --- RENDER MULTIHILO: RASTERIZADO POR TILES ---
+// Cada hilo toma el siguiente tile libre (contador atómico) y ejecuta su lista de
+// comandos recortando cada uno al tile: dos hilos nunca escriben el mismo píxel, así
+// que no hace falta ningún bloqueo. Los sprites pasan por GE_BlitSpriteRegionNow con un
+// contexto mínimo propio de cada hilo (buffer destino, recorte, modo y filtro).
+
+static void GE_RasterTile(GE_RenderQueue* q, GE_Context* local, int tile) {
+    int w = local->render_width;
+    int tx0 = (tile % q->tiles_x) * GE_RENDER_TILE, ty0 = (tile / q->tiles_x) * GE_RENDER_TILE;
+    int tx1 = tx0 + GE_RENDER_TILE < w ? tx0 + GE_RENDER_TILE : w;
+    int ty1 = ty0 + GE_RENDER_TILE < local->render_height ? ty0 + GE_RENDER_TILE : local->render_height;
+
+    const uint32_t* bin = q->bins[tile];
+    for (int i = 0; i < q->bin_count[tile]; i++) {
+        const GE_RenderCmd* cmd = &q->cmds[bin[i]];
+        if (cmd->type == GE_RCMD_SPAN) {
+            int x0 = cmd->x0 > tx0 ? cmd->x0 : tx0;
+            int x1 = cmd->x1 < tx1 - 1 ? cmd->x1 : tx1 - 1;
+            GE_BlendSolidSpan(cmd->target + (size_t)cmd->y * w + x0, x1 - x0 + 1, cmd->color, (GE_BlendMode)cmd->mode);
+        } else if (cmd->type == GE_RCMD_FILL) {
+            for (int y = ty0; y < ty1; y++) {
+                uint32_t* row = cmd->target + (size_t)y * w;
+                for (int x = tx0; x < tx1; x++) row[x] = cmd->color;
+            }
+        } else {
+            const GE_DeferredCmd* sp = &q->sprites[cmd->y];
+            local->render_buffer = cmd->target;
+            local->clip_x0 = sp->x0 > tx0 ? sp->x0 : tx0;
+            local->clip_y0 = sp->y0 > ty0 ? sp->y0 : ty0;
+            local->clip_x1 = sp->x1 < tx1 ? sp->x1 : tx1;
+            local->clip_y1 = sp->y1 < ty1 ? sp->y1 : ty1;
+            local->blend_mode = sp->mode;
+            local->texture_filter = sp->filter;
+            GE_Tint t = GE_MakeTint(sp->tint);
+            GE_BlitSpriteRegionNow(local, sp->sprite, sp->src_x, sp->src_y, sp->src_w, sp->src_h,
+                                   sp->dest_x, sp->dest_y, sp->dest_w, sp->dest_h, sp->flip, &t);
+        }
+    }
+}
+
+static void GE_RasterTiles(GE_RenderQueue* q, GE_Context* local) {
+    int total = q->tiles_x * q->tiles_y;
+    for (;;) {
+        int tile = (int)ma_atomic_fetch_add_32(&q->next_tile, 1);
+        if (tile >= total) break;
+        if (q->bin_count[tile] > 0) GE_RasterTile(q, local, tile);
+    }
+}
+
+static ma_thread_result MA_THREADCALL GE_RenderWorkerMain(void* data) {
+    GE_RenderWorker* worker = (GE_RenderWorker*)data;
+    GE_RenderQueue* q = worker->queue;
+    for (;;) {
+        ma_semaphore_wait(&q->start);
+        if (q->quit) break;
+        GE_RasterTiles(q, worker->local);
+        ma_semaphore_release(&q->done);
+    }
+    return (ma_thread_result)0;
+}
+
+// Contexto mínimo para los blitters de un hilo (solo lee buffer, tamaño, recorte y modos)
+static GE_Context* GE_CreateRenderLocal(GE_Context* ctx) {
+    GE_Context* local = (GE_Context*)calloc(1, sizeof(GE_Context));
+    if (!local) return NULL;
+    local->render_width = ctx->render_width;
+    local->render_height = ctx->render_height;
+    local->clip_enabled = true;
+    return local;
+}
+
+void GE_FlushRendering(GE_Context* ctx) {
+    if (!ctx || !ctx->render_queue || ctx->render_queue->count == 0) return;
+    GE_RenderQueue* q = ctx->render_queue;
+
+    q->next_tile = 0;
+    for (int i = 0; i < q->worker_count; i++) ma_semaphore_release(&q->start);
+    GE_RasterTiles(q, q->main_local);
+    for (int i = 0; i < q->worker_count; i++) ma_semaphore_wait(&q->done);
+
+    for (int t = 0; t < q->tiles_x * q->tiles_y; t++) q->bin_count[t] = 0;
+    q->count = 0;
+    q->sprite_count = 0;
+}
+
+void GE_EnableThreadedRendering(GE_Context* ctx, int thread_count) {
+    if (!ctx) return;
+
+    GE_RenderQueue* q = ctx->render_queue;
+    if (q) {
+        GE_FlushRendering(ctx);
+        q->quit = true;
+        for (int i = 0; i < q->worker_count; i++) ma_semaphore_release(&q->start);
+        for (int i = 0; i < q->worker_count; i++) {
+            ma_thread_wait(&q->workers[i].thread);
+            free(q->workers[i].local);
+        }
+        ma_semaphore_uninit(&q->start);
+        ma_semaphore_uninit(&q->done);
+        for (int t = 0; t < q->tiles_x * q->tiles_y; t++) free(q->bins[t]);
+        free(q->bins);
+        free(q->bin_count);
+        free(q->bin_capacity);
+        free(q->cmds);
+        free(q->sprites);
+        free(q->workers);
+        free(q->main_local);
+        free(q);
+        ctx->render_queue = NULL;
+    }
+    if (thread_count <= 1 || ctx->render_width <= 0 || ctx->render_height <= 0) return;
+
+    q = (GE_RenderQueue*)calloc(1, sizeof(GE_RenderQueue));
+    if (!q) return;
+    q->tiles_x = (ctx->render_width + GE_RENDER_TILE - 1) / GE_RENDER_TILE;
+    q->tiles_y = (ctx->render_height + GE_RENDER_TILE - 1) / GE_RENDER_TILE;
+    int tiles = q->tiles_x * q->tiles_y;
+    q->bins = (uint32_t**)calloc(tiles, sizeof(uint32_t*));
+    q->bin_count = (int*)calloc(tiles, sizeof(int));
+    q->bin_capacity = (int*)calloc(tiles, sizeof(int));
+    q->workers = (GE_RenderWorker*)calloc(thread_count - 1, sizeof(GE_RenderWorker));
+    q->main_local = GE_CreateRenderLocal(ctx);
+    if (!q->bins || !q->bin_count || !q->bin_capacity || !q->workers || !q->main_local ||
+        ma_semaphore_init(0, &q->start) != MA_SUCCESS) {
+        printf("[GE] Error: No se pudo iniciar el render multihilo\n");
+        free(q->bins); free(q->bin_count); free(q->bin_capacity); free(q->workers); free(q->main_local); free(q);
+        return;
+    }
+    ma_semaphore_init(0, &q->done);
+    ctx->render_queue = q;
+
+    // Si un hilo no arranca se sigue con los que haya (con 0, rasteriza solo el principal)
+    for (int i = 0; i < thread_count - 1; i++) {
+        GE_RenderWorker* worker = &q->workers[q->worker_count];
+        worker->queue = q;
+        worker->local = GE_CreateRenderLocal(ctx);
+        if (!worker->local) break;
+        if (ma_thread_create(&worker->thread, ma_thread_priority_normal, 0, GE_RenderWorkerMain, worker, NULL) != MA_SUCCESS) {
+            free(worker->local);
+            break;
+        }
+        q->worker_count++;
+    }
+}
+
+void GE_DrawSpriteFlipped(GE_Context* ctx, GE_Sprite* sprite, GE_Rect src, GE_Rect dest, int flip, GE_Color tint) {
+    if (!ctx || !sprite || !sprite->data) return;
+
+    int src_x = (int)src.x, src_y = (int)src.y, src_w = (int)src.w, src_h = (int)src.h;
+    int dest_w = (int)dest.w, dest_h = (int)dest.h;
+    GE_Sprite* level = GE_SelectMipLevel(sprite, &src_x, &src_y, &src_w, &src_h, dest_w, dest_h);
+
+    GE_Tint t = GE_MakeTint(tint);
+    GE_BlitSpriteRegion(ctx, level, src_x, src_y, src_w, src_h, (int)dest.x, (int)dest.y, dest_w, dest_h, flip, &t);
+}
+
+void GE_DrawSpriteEx(GE_Context* ctx, GE_Sprite* sprite, GE_Rect src, GE_Rect dest, GE_Color tint) {
+    GE_DrawSpriteFlipped(ctx, sprite, src, dest, GE_FLIP_NONE, tint);
+}
+
+// --- DIBUJADO POR LOTES (BATCH) ---
+// Un lote amortiza todo lo que GE_DrawSpriteEx hace por llamada: se valida una sola vez,
+// se descartan en bloque las instancias fuera de pantalla y el tinte solo se vuelve a
+// desempaquetar cuando cambia. Por defecto se respeta el orden de envío; la variante
+// ordenada agrupa por región fuente (las que leen el mismo cuadro quedan juntas y su
+// textura sigue en caché) y solo es segura si las instancias no se solapan.
+
+// Asegura capacidad en el buffer temporal del lote (se reutiliza entre frames)
+static bool GE_ReserveBatchKeys(GE_Context* ctx, int count) {
+    if (count <= ctx->batch_capacity) return true;
+    int new_cap = ctx->batch_capacity ? ctx->batch_capacity : 256;
+    while (new_cap < count) new_cap *= 2;
+    uint64_t* keys = (uint64_t*)realloc(ctx->batch_keys, new_cap * sizeof(uint64_t));
+    if (!keys) return false;
+    ctx->batch_keys = keys;
+    ctx->batch_capacity = new_cap;
+    return true;
+}
+
+static int GE_CompareBatchKeys(const void* a, const void* b) {
+    uint64_t ka = *(const uint64_t*)a, kb = *(const uint64_t*)b;
+    return (ka > kb) - (ka < kb);
+}
+
+static void GE_DrawSpriteBatchImpl(GE_Context* ctx, GE_Sprite* sprite, const GE_SpriteInstance* instances, int count, bool by_region) {
+    if (!ctx || !ctx->render_buffer || !sprite || !sprite->data || !instances || count <= 0) return;
+    if (!GE_ReserveBatchKeys(ctx, count)) return;
+
+    // 1. Culling en bloque. Clave = [región fuente (32 bits, 0 sin agrupar) | índice original
+    //    (32 bits)], así el orden de envío se conserva dentro de cada grupo.
+    int visible = 0;
+    bool sorted = true;
+    for (int i = 0; i < count; i++) {
+        const GE_SpriteInstance* inst = &instances[i];
+        float w = inst->dest.w > 0 ? inst->dest.w : (inst->src.w > 0 ? inst->src.w : (float)sprite->width);
+        float h = inst->dest.h > 0 ? inst->dest.h : (inst->src.h > 0 ? inst->src.h : (float)sprite->height);
+        if (inst->dest.x >= ctx->render_width || inst->dest.y >= ctx->render_height ||
+            inst->dest.x + w <= 0 || inst->dest.y + h <= 0) continue;
+
+        uint32_t region = by_region ? (((uint32_t)((int)inst->src.y & 0xFFFF) << 16) | (uint32_t)((int)inst->src.x & 0xFFFF)) : 0;
+        uint64_t key = ((uint64_t)region << 32) | (uint32_t)i;
+        if (visible > 0 && key < ctx->batch_keys[visible - 1]) sorted = false;
+        ctx->batch_keys[visible++] = key;
+    }
+
+    // 2. Agrupar por región fuente (si todas usan la misma, ya viene ordenado)
+    if (!sorted) qsort(ctx->batch_keys, visible, sizeof(uint64_t), GE_CompareBatchKeys);
+
+    if (visible == 0) return;
+
+    // 3. Dibujar
+    GE_Tint t = GE_MakeTint(instances[ctx->batch_keys[0] & 0xFFFFFFFF].tint);
+    for (int k = 0; k < visible; k++) {
+        const GE_SpriteInstance* inst = &instances[ctx->batch_keys[k] & 0xFFFFFFFF];
+        if (inst->tint != t.color) t = GE_MakeTint(inst->tint);
+
+        int src_x = (int)inst->src.x, src_y = (int)inst->src.y;
+        int src_w = inst->src.w > 0 ? (int)inst->src.w : sprite->width;
+        int src_h = inst->src.h > 0 ? (int)inst->src.h : sprite->height;
+        int dest_w = inst->dest.w > 0 ? (int)inst->dest.w : src_w;
+        int dest_h = inst->dest.h > 0 ? (int)inst->dest.h : src_h;
+        GE_Sprite* level = GE_SelectMipLevel(sprite, &src_x, &src_y, &src_w, &src_h, dest_w, dest_h);
+        GE_BlitSpriteRegion(ctx, level, src_x, src_y, src_w, src_h,
+                            (int)inst->dest.x, (int)inst->dest.y, dest_w, dest_h, GE_FLIP_NONE, &t);
+    }
+}
+
+void GE_DrawSpriteBatch(GE_Context* ctx, GE_Sprite* sprite, const GE_SpriteInstance* instances, int count) {
+    GE_DrawSpriteBatchImpl(ctx, sprite, instances, count, false);
+}
+
+void GE_DrawSpriteBatchSorted(GE_Context* ctx, GE_Sprite* sprite, const GE_SpriteInstance* instances, int count) {
+    GE_DrawSpriteBatchImpl(ctx, sprite, instances, count, true);
+}
+
+// --- DEFORMACIÓN DE SPRITES (QUAD WARPING) ---
+// Rasterizamos por "spans" (tramos horizontales): caminamos los bordes de cada triángulo
+// fila por fila y solo visitamos los píxeles que quedan dentro (nada de cajas delimitadoras
+// con tests baricéntricos por píxel). La textura se muestrea con un plano homogéneo
+// (U, V, W) que es lineal en pantalla, así que a lo largo de un span solo se suma un paso:
+//   - Afín:        W = 1 constante  -> sin división por píxel.
+//   - Perspectiva: u = U/W, v = V/W -> una división por píxel.
+
+typedef struct {
+    float u[3]; // U = u[0]*x + u[1]*y + u[2]  (en coordenadas de texel)
+    float v[3];
+    float w[3];
+} GE_TexPlane;
+
+// Límites enteros (inclusive) del rectángulo fuente ya recortado al sprite
+typedef struct {
+    int x0, y0, x1, y1;
+} GE_TexClamp;
+
+// Recorta el rect fuente al sprite. Retorna false si no queda nada que muestrear.
+static bool GE_ClampSourceRect(GE_Sprite* sprite, GE_Rect src, GE_TexClamp* out) {
+    out->x0 = (int)src.x;
+    out->y0 = (int)src.y;
+    out->x1 = (int)(src.x + src.w) - 1;
+    out->y1 = (int)(src.y + src.h) - 1;
+    if (out->x0 < 0) out->x0 = 0;
+    if (out->y0 < 0) out->y0 = 0;
+    if (out->x1 >= sprite->width) out->x1 = sprite->width - 1;
+    if (out->y1 >= sprite->height) out->y1 = sprite->height - 1;
+    return out->x0 <= out->x1 && out->y0 <= out->y1;
+}
+
+// Plano afín que lleva los 3 vértices de pantalla a sus coordenadas de texel
+static bool GE_BuildAffinePlane(GE_Point p0, GE_Point p1, GE_Point p2, GE_Point t0, GE_Point t1, GE_Point t2, GE_TexPlane* tp) {
+    float den = (p1.x - p0.x) * (p2.y - p0.y) - (p2.x - p0.x) * (p1.y - p0.y);
+    if (fabsf(den) < 1e-6f) return false; // Triángulo degenerado
+
+    float dudx = ((t1.x - t0.x) * (p2.y - p0.y) - (t2.x - t0.x) * (p1.y - p0.y)) / den;
+    float dudy = ((t2.x - t0.x) * (p1.x - p0.x) - (t1.x - t0.x) * (p2.x - p0.x)) / den;
+    float dvdx = ((t1.y - t0.y) * (p2.y - p0.y) - (t2.y - t0.y) * (p1.y - p0.y)) / den;
+    float dvdy = ((t2.y - t0.y) * (p1.x - p0.x) - (t1.y - t0.y) * (p2.x - p0.x)) / den;
+
+    tp->u[0] = dudx; tp->u[1] = dudy; tp->u[2] = t0.x - dudx * p0.x - dudy * p0.y;
+    tp->v[0] = dvdx; tp->v[1] = dvdy; tp->v[2] = t0.y - dvdx * p0.x - dvdy * p0.y;
+    tp->w[0] = 0.0f; tp->w[1] = 0.0f; tp->w[2] = 1.0f;
+    return true;
+}
+
+// Homografía pantalla -> texel para el quad completo (Heckbert: cuadrado -> quad, invertida).
+// Si el quad es un paralelogramo, el resultado es afín y *is_affine queda en true.
+static bool GE_BuildPerspectivePlane(const GE_Point q[4], GE_Rect src, GE_TexPlane* tp, bool* is_affine) {
+    float sx = q[0].x - q[1].x + q[2].x - q[3].x;
+    float sy = q[0].y - q[1].y + q[2].y - q[3].y;
+    float a, b, c, d, e, f, g, h;
+
+    if (fabsf(sx) < 1e-4f && fabsf(sy) < 1e-4f) {
+        a = q[1].x - q[0].x; b = q[2].x - q[1].x; c = q[0].x;
+        d = q[1].y - q[0].y; e = q[2].y - q[1].y; f = q[0].y;
+        g = 0.0f; h = 0.0f;
+    } else {
+        float dx1 = q[1].x - q[2].x, dx2 = q[3].x - q[2].x;
+        float dy1 = q[1].y - q[2].y, dy2 = q[3].y - q[2].y;
+        float det = dx1 * dy2 - dx2 * dy1;
+        if (fabsf(det) < 1e-6f) return false;
+        g = (sx * dy2 - dx2 * sy) / det;
+        h = (dx1 * sy - sx * dy1) / det;
+        a = q[1].x - q[0].x + g * q[1].x; b = q[3].x - q[0].x + h * q[3].x; c = q[0].x;
+        d = q[1].y - q[0].y + g * q[1].y; e = q[3].y - q[0].y + h * q[3].y; f = q[0].y;
+    }
+
+    // Adjunta de [[a b c][d e f][g h 1]] = inversa salvo escala (la escala se cancela en U/W)
+    float A[3][3] = {
+        { e - f * h, c * h - b, b * f - c * e },
+        { f * g - d, a - c * g, c * d - a * f },
+        { d * h - e * g, b * g - a * h, a * e - b * d }
+    };
+
+    // Pasar de [0,1] al rect fuente: u_tex = src.x + src.w * u  ->  U' = src.w*U + src.x*W
+    for (int i = 0; i < 3; i++) {
+        tp->u[i] = src.w * A[0][i] + src.x * A[2][i];
+        tp->v[i] = src.h * A[1][i] + src.y * A[2][i];
+        tp->w[i] = A[2][i];
+    }
+
+    // W debe ser positivo dentro del quad (evaluamos en el centroide)
+    float cx = (q[0].x + q[1].x + q[2].x + q[3].x) * 0.25f;
+    float cy = (q[0].y + q[1].y + q[2].y + q[3].y) * 0.25f;
+    float wc = tp->w[0] * cx + tp->w[1] * cy + tp->w[2];
+    if (fabsf(wc) < 1e-12f) return false;
+
+    *is_affine = (fabsf(g) < 1e-9f && fabsf(h) < 1e-9f);
+    if (*is_affine || wc < 0.0f) {
+        // Normalizamos: en el caso afín W queda exactamente en 1
+        float k = *is_affine ? 1.0f / wc : -1.0f;
+        for (int i = 0; i < 3; i++) { tp->u[i] *= k; tp->v[i] *= k; tp->w[i] *= k; }
+    }
+    return true;
+}
+
+// Span de quad con filtro bilineal: recolecta por tramos los 4 vecinos de cada píxel
+// (u, v en el centro del píxel, desplazados medio texel) y los resuelve en bloque.
+static void GE_QuadSpanBilinear(GE_Context* ctx, GE_Sprite* sprite, uint32_t* dst, int count, float U, float V, float W,
+                                const GE_TexPlane* tp, bool perspective, const GE_TexClamp* clamp, const GE_Tint* tint) {
+    bool premultiply = !GE_SpriteDataPremultiplied(sprite) && !GE_SpriteIsOpaque(sprite);
+    GE_BilinearChunk chunk;
+
+    for (int start = 0; start < count; start += GE_FILTER_CHUNK) {
+        int n = count - start < GE_FILTER_CHUNK ? count - start : GE_FILTER_CHUNK;
+        for (int k = 0; k < n; k++) {
+            float fu = U, fv = V;
+            bool visible = true;
+            if (perspective) {
+                visible = W > 0.0f;
+                if (visible) { float inv_w = 1.0f / W; fu *= inv_w; fv *= inv_w; }
+                W += tp->w[0];
+            }
+            U += tp->u[0];
+            V += tp->v[0];
+
+            if (!visible) {
+                chunk.tl[k] = chunk.tr[k] = chunk.bl[k] = chunk.br[k] = 0; // Transparente: no pinta
+                chunk.fx[k] = chunk.fy[k] = 0;
+                continue;
+            }
+
+            // A 24.8 acotando antes (cerca del horizonte u/v pueden dispararse)
+            fu = fminf(fmaxf(fu - 0.5f, (float)clamp->x0 - 1.0f), (float)clamp->x1 + 1.0f);
+            fv = fminf(fmaxf(fv - 0.5f, (float)clamp->y0 - 1.0f), (float)clamp->y1 + 1.0f);
+            int x0, x1, y0, y1;
+            GE_FilterTaps((int)floorf(fu * 256.0f), clamp->x0, clamp->x1, &x0, &x1, &chunk.fx[k]);
+            GE_FilterTaps((int)floorf(fv * 256.0f), clamp->y0, clamp->y1, &y0, &y1, &chunk.fy[k]);
+            const unsigned char* row0 = GE_TexelRowOrNull(sprite, y0);
+            const unsigned char* row1 = GE_TexelRowOrNull(sprite, y1);
+            chunk.tl[k] = GE_FetchTexel(sprite, row0, x0);
+            chunk.tr[k] = GE_FetchTexel(sprite, row0, x1);
+            chunk.bl[k] = GE_FetchTexel(sprite, row1, x0);
+            chunk.br[k] = GE_FetchTexel(sprite, row1, x1);
+        }
+        GE_BilinearResolve(&chunk, n, premultiply);
+        GE_BlendFilteredSpan(&dst[start], n, chunk.out, ctx->blend_mode, tint);
+    }
+}
+
+// Rasteriza un triángulo texturizado caminando sus bordes (regla de centro de píxel,
+// así dos triángulos que comparten arista no dejan huecos ni pintan dos veces)
+static void GE_RasterTexturedTriangle(GE_Context* ctx, GE_Sprite* sprite, GE_Point v0, GE_Point v1, GE_Point v2,
+                                      const GE_TexPlane* tp, bool perspective, const GE_TexClamp* clamp, GE_Color tint) {
+    // Ordenar por Y (v0 arriba, v2 abajo)
+    GE_Point tmp;
+    if (v1.y < v0.y) { tmp = v0; v0 = v1; v1 = tmp; }
+    if (v2.y < v1.y) { tmp = v1; v1 = v2; v2 = tmp; }
+    if (v1.y < v0.y) { tmp = v0; v0 = v1; v1 = tmp; }
+
+    int y_start = (int)ceilf(v0.y - 0.5f);
+    int y_end   = (int)ceilf(v2.y - 0.5f); // Exclusivo
+    if (y_start < 0) y_start = 0;
+    if (y_end > ctx->render_height) y_end = ctx->render_height;
+    if (y_start >= y_end) return;
+
+    float s02 = (v2.y - v0.y) > 0.0f ? (v2.x - v0.x) / (v2.y - v0.y) : 0.0f;
+    float s01 = (v1.y - v0.y) > 0.0f ? (v1.x - v0.x) / (v1.y - v0.y) : 0.0f;
+    float s12 = (v2.y - v1.y) > 0.0f ? (v2.x - v1.x) / (v2.y - v1.y) : 0.0f;
+
+    GE_Tint t = GE_MakeTint(tint);
+    GE_TexelFn shade = g_texel_table[ctx->blend_mode][GE_SourceKind(sprite)];
+    bool bilinear = ctx->texture_filter == GE_FILTER_BILINEAR;
+
+    // Posición inicial de los bordes en el centro de la primera fila
+    float yc = (float)y_start + 0.5f;
+    bool lower_half = (yc >= v1.y);
+    float x_long  = v0.x + (yc - v0.y) * s02;
+    float x_short = lower_half ? v1.x + (yc - v1.y) * s12 : v0.x + (yc - v0.y) * s01;
+
+    for (int y = y_start; y < y_end; y++, yc += 1.0f) {
+        if (!lower_half && yc >= v1.y) {
+            lower_half = true;
+            x_short = v1.x + (yc - v1.y) * s12;
+        }
+
+        float xl = x_long < x_short ? x_long : x_short;
+        float xr = x_long < x_short ? x_short : x_long;
+        x_long  += s02;
+        x_short += lower_half ? s12 : s01;
+
+        int x_begin = (int)ceilf(xl - 0.5f);
+        int x_end   = (int)ceilf(xr - 0.5f); // Exclusivo
+        if (x_begin < 0) x_begin = 0;
+        if (x_end > ctx->render_width) x_end = ctx->render_width;
+        if (x_begin >= x_end) continue;
+
+        // Plano evaluado al inicio del span; a partir de aquí solo sumamos el paso en X
+        float px = (float)x_begin + 0.5f;
+        float U = tp->u[0] * px + tp->u[1] * yc + tp->u[2];
+        float V = tp->v[0] * px + tp->v[1] * yc + tp->v[2];
+        float W = tp->w[0] * px + tp->w[1] * yc + tp->w[2];
+        uint32_t* dst = &ctx->render_buffer[y * ctx->render_width + x_begin];
+
+        if (bilinear) {
+            GE_QuadSpanBilinear(ctx, sprite, dst, x_end - x_begin, U, V, W, tp, perspective, clamp, &t);
+            continue;
+        }
+
+        for (int x = x_begin; x < x_end; x++, dst++) {
+            float fu = U, fv = V;
+            if (perspective) {
+                if (W <= 0.0f) { U += tp->u[0]; V += tp->v[0]; W += tp->w[0]; continue; }
+                float inv_w = 1.0f / W;
+                fu *= inv_w;
+                fv *= inv_w;
+                W += tp->w[0];
+            }
+            U += tp->u[0];
+            V += tp->v[0];
+
+            int sx = (int)fu;
+            int sy = (int)fv;
+            if (sx < clamp->x0) sx = clamp->x0; else if (sx > clamp->x1) sx = clamp->x1;
+            if (sy < clamp->y0) sy = clamp->y0; else if (sy > clamp->y1) sy = clamp->y1;
+
+            // Fuera de la zona almacenada (borde recortado) es transparente
+            int tx = sx - sprite->trim_x, ty = sy - sprite->trim_y;
+            if ((unsigned)tx >= (unsigned)sprite->trim_w || (unsigned)ty >= (unsigned)sprite->trim_h) continue;
+            shade(dst, GE_TexelAddress(sprite, tx, ty), &t);
+        }
+    }
+}
+
+void GE_DrawSpriteQuadEx(GE_Context* ctx, GE_Sprite* sprite, GE_Rect src, const GE_Point quad[4], GE_QuadMode mode, GE_Color tint) {
+    if (!ctx || !ctx->render_buffer || !sprite || !sprite->data || !quad) return;
+    GE_FlushRendering(ctx); // Se rasteriza en el hilo principal: lo grabado antes va primero
+
+    GE_TexClamp clamp;
+    if (!GE_ClampSourceRect(sprite, src, &clamp)) return;
+
+    // Descarte rápido si el quad queda totalmente fuera de pantalla
+    float min_x = quad[0].x, max_x = quad[0].x, min_y = quad[0].y, max_y = quad[0].y;
+    for (int i = 1; i < 4; i++) {
+        min_x = fminf(min_x, quad[i].x); max_x = fmaxf(max_x, quad[i].x);
+        min_y = fminf(min_y, quad[i].y); max_y = fmaxf(max_y, quad[i].y);
+    }
+    if (max_x < 0 || max_y < 0 || min_x >= ctx->render_width || min_y >= ctx->render_height) return;
+
+    // Esquinas de la textura en coordenadas de texel (mismo orden que el quad)
+    GE_Point t[4] = {
+        { src.x,         src.y },
+        { src.x + src.w, src.y },
+        { src.x + src.w, src.y + src.h },
+        { src.x,         src.y + src.h }
+    };
+
+    if (mode == GE_QUAD_PERSPECTIVE) {
+        // Un solo plano proyectivo para todo el quad: sin costura en la diagonal
+        GE_TexPlane tp;
+        bool is_affine = false;
+        if (!GE_BuildPerspectivePlane(quad, src, &tp, &is_affine)) return;
+        GE_RasterTexturedTriangle(ctx, sprite, quad[0], quad[1], quad[2], &tp, !is_affine, &clamp, tint);
+        GE_RasterTexturedTriangle(ctx, sprite, quad[0], quad[2], quad[3], &tp, !is_affine, &clamp, tint);
+    } else {
+        // Afín: cada triángulo tiene su propio plano
+        GE_TexPlane tp;
+        if (GE_BuildAffinePlane(quad[0], quad[1], quad[2], t[0], t[1], t[2], &tp))
+            GE_RasterTexturedTriangle(ctx, sprite, quad[0], quad[1], quad[2], &tp, false, &clamp, tint);
+        if (GE_BuildAffinePlane(quad[0], quad[2], quad[3], t[0], t[2], t[3], &tp))
+            GE_RasterTexturedTriangle(ctx, sprite, quad[0], quad[2], quad[3], &tp, false, &clamp, tint);
+    }
+}
+
+void GE_DrawSpriteQuad(GE_Context* ctx, GE_Sprite* sprite, GE_Point p1, GE_Point p2, GE_Point p3, GE_Point p4, GE_Color tint) {
+    if (!sprite) return;
+    GE_Rect src = { 0, 0, (float)sprite->width, (float)sprite->height };
+    GE_Point quad[4] = { p1, p2, p3, p4 };
+    GE_DrawSpriteQuadEx(ctx, sprite, src, quad, GE_QUAD_PERSPECTIVE, tint);
+}
+
+// Rotación por software: giramos las 4 esquinas alrededor de 'origin' y
+// rasterizamos el quad resultante (mapeo inverso afín, Nearest Neighbor).
+void GE_DrawSpritePro(GE_Context* ctx, GE_Sprite* sprite, GE_Rect src, GE_Rect dest, GE_Point origin, float rotation, GE_Color tint) {
+    if (rotation == 0.0f) {
+        // Sin rotación: el camino escalado normal es más rápido
+        GE_Rect final_dest = { dest.x - origin.x, dest.y - origin.y, dest.w, dest.h };
+        GE_DrawSpriteEx(ctx, sprite, src, final_dest, tint);
+        return;
+    }
+
+    float rad = rotation * 3.14159f / 180.0f;
+    float cos_r = cosf(rad);
+    float sin_r = sinf(rad);
+
+    // Esquinas locales relativas al pivote
+    float lx[4] = { -origin.x, dest.w - origin.x, dest.w - origin.x, -origin.x };
+    float ly[4] = { -origin.y, -origin.y, dest.h - origin.y, dest.h - origin.y };
+
+    GE_Point quad[4];
+    for (int i = 0; i < 4; i++) {
+        quad[i].x = dest.x + lx[i] * cos_r - ly[i] * sin_r;
+        quad[i].y = dest.y + lx[i] * sin_r + ly[i] * cos_r;
+    }
+    GE_DrawSpriteQuadEx(ctx, sprite, src, quad, GE_QUAD_AFFINE, tint);
+}
+
+// --- CACHÉ DE SPRITES TRANSFORMADOS ---
+// Para sprites que se dibujan una y otra vez con las mismas pocas rotaciones y escalas
+// (objetos que giran, niveles de zoom): la primera vez se renderiza la versión
+// transformada en una imagen propia y las siguientes se copian 1:1, sin muestreo inverso.
+// Ángulo y escala se cuantizan para que dibujos casi iguales compartan entrada.
+// Cuando no cabe una entrada nueva se expulsa la usada hace más tiempo (LRU).
+
+#define GE_XFORM_ANGLE_STEPS 256 // Pasos por vuelta (~1.4 grados)
+#define GE_XFORM_SCALE_STEPS 32  // Pasos por unidad de escala
+
+typedef struct {
+    uint32_t serial;                // GE_Sprite::serial del origen
+    uint32_t palette_serial;        // Versión de la paleta (0 si es RGBA)
+    int src_x, src_y, src_w, src_h; // Región fuente
+    int angle_bucket, scale_bucket;
+    GE_TextureFilter filter;
+    GE_Sprite* image;               // Resultado con memoria propia
+    float center_x, center_y;       // Centro de la región fuente dentro de 'image'
+    size_t bytes;
+    uint64_t last_used;
+    uint64_t pinned_pass;           // Grabada en esta pasada diferida: no se expulsa hasta dibujarla
+} GE_TransformEntry;
+
+struct GE_TransformCache {
+    GE_TransformEntry* entries;
+    int count, capacity;
+    size_t budget, used;
+    uint64_t tick;
+    uint64_t hits, misses, evictions;
+};
+
+static void GE_FreeCachedImage(GE_Sprite* image) {
+    if (!image) return;
+    free(image->data);
+    free(image);
+}
+
+static void GE_EvictTransformEntry(struct GE_TransformCache* cache, int index) {
+    cache->used -= cache->entries[index].bytes;
+    GE_FreeCachedImage(cache->entries[index].image);
+    cache->entries[index] = cache->entries[--cache->count];
+    cache->evictions++;
+}
+
+// Pasada diferida que está grabando (0 = ninguna): sus entradas no se pueden liberar aún
+static uint64_t GE_TransformCachePin(GE_Context* ctx) {
+    return (ctx->deferred && ctx->deferred->recording) ? ctx->deferred->pass_id : 0;
+}
+
+// Libera la imagen de una entrada que sale de la caché. Si la pasada diferida en curso
+// la tiene grabada se aplaza hasta GE_EndDeferredSprites.
+static void GE_ReleaseTransformEntry(GE_Context* ctx, const GE_TransformEntry* entry) {
+    GE_DeferredPass* pass = ctx->deferred;
+    if (pass && pass->recording && entry->pinned_pass == pass->pass_id) {
+        if (pass->retired_count == pass->retired_capacity) {
+            int new_cap = pass->retired_capacity ? pass->retired_capacity * 2 : 16;
+            GE_Sprite** list = (GE_Sprite**)realloc(pass->retired, new_cap * sizeof(GE_Sprite*));
+            if (list) {
+                pass->retired = list;
+                pass->retired_capacity = new_cap;
+            } else {
+                // Sin memoria para aplazarla: se dibuja ya lo grabado y se sigue en una pasada nueva
+                GE_EndDeferredSprites(ctx);
+                GE_BeginDeferredSprites(ctx);
+            }
+        }
+        if (entry->pinned_pass == pass->pass_id) {
+            pass->retired[pass->retired_count++] = entry->image;
+            return;
+        }
+    }
+    GE_FreeCachedImage(entry->image);
+}
+
+// Expulsa las entradas menos usadas hasta que 'extra' bytes más quepan en el presupuesto.
+// Las fijadas por la pasada diferida en curso ('pinned_pass', 0 = ninguna) se respetan.
+static void GE_TrimTransformCache(struct GE_TransformCache* cache, size_t extra, uint64_t pinned_pass) {
+    while (cache->used + extra > cache->budget) {
+        int lru = -1;
+        for (int i = 0; i < cache->count; i++) {
+            if (pinned_pass && cache->entries[i].pinned_pass == pinned_pass) continue;
+            if (lru < 0 || cache->entries[i].last_used < cache->entries[lru].last_used) lru = i;
+        }
+        if (lru < 0) return;
+        GE_EvictTransformEntry(cache, lru);
+    }
+}
+
+void GE_EnableTransformCache(GE_Context* ctx, size_t budget_bytes) {
+    if (!ctx) return;
+    struct GE_TransformCache* cache = ctx->xform_cache;
+
+    if (budget_bytes == 0) {
+        if (!cache) return;
+        GE_ClearTransformCache(ctx);
+        free(cache->entries);
+        free(cache);
+        ctx->xform_cache = NULL;
+        return;
+    }
+
+    if (!cache) {
+        cache = (struct GE_TransformCache*)calloc(1, sizeof(struct GE_TransformCache));
+        if (!cache) {
+            printf("[GE] Error: Sin memoria para la cache de transformaciones\n");
+            return;
+        }
+        ctx->xform_cache = cache;
+    }
+    cache->budget = budget_bytes;
+    // Expulsar libera imágenes que la cola del render multihilo aún puede leer
+    if (ctx->render_queue && cache->used > cache->budget) GE_FlushRendering(ctx);
+    GE_TrimTransformCache(cache, 0, GE_TransformCachePin(ctx));
+}
+
+void GE_ClearTransformCache(GE_Context* ctx) {
+    if (!ctx || !ctx->xform_cache) return;
+    GE_FlushRendering(ctx); // Puede haber dibujos grabados que leen estas imágenes
+    struct GE_TransformCache* cache = ctx->xform_cache;
+    for (int i = 0; i < cache->count; i++) GE_ReleaseTransformEntry(ctx, &cache->entries[i]);
+    cache->count = 0;
+    cache->used = 0;
+}
+
+GE_TransformCacheStats GE_GetTransformCacheStats(GE_Context* ctx) {
+    GE_TransformCacheStats stats = { 0 };
+    if (!ctx || !ctx->xform_cache) return stats;
+    struct GE_TransformCache* cache = ctx->xform_cache;
+    stats.hits = cache->hits;
+    stats.misses = cache->misses;
+    stats.evictions = cache->evictions;
+    stats.bytes_used = cache->used;
+    stats.budget = cache->budget;
+    stats.entry_count = cache->count;
+    return stats;
+}
+
+// Renderiza la región fuente rotada 'angle' (radianes) y escalada 'scale' en una imagen
+// nueva del tamaño de su caja envolvente. Muestreo inverso una sola vez, con el filtro pedido.
+static GE_Sprite* GE_RenderTransformed(GE_Sprite* sprite, int src_x, int src_y, int src_w, int src_h,
+                                       float angle, float scale, GE_TextureFilter filter,
+                                       float* center_x, float* center_y) {
+    float c = cosf(angle), s = sinf(angle);
+    float w = src_w * scale, h = src_h * scale;
+    int out_w = (int)ceilf(fabsf(c) * w + fabsf(s) * h);
+    int out_h = (int)ceilf(fabsf(s) * w + fabsf(c) * h);
+    // Tamaño par: el centro cae en un borde de píxel y el dibujo 1:1 no se desplaza medio píxel
+    out_w = (out_w + 1) & ~1;
+    out_h = (out_h + 1) & ~1;
+    if (out_w < 2) out_w = 2;
+    if (out_h < 2) out_h = 2;
+
+    unsigned char* data = (unsigned char*)calloc((size_t)out_w * out_h, 4);
+    GE_Sprite* image = (GE_Sprite*)calloc(1, sizeof(GE_Sprite));
+    if (!data || !image) { free(data); free(image); return NULL; }
+    GE_InitSpriteFull(image, out_w, out_h, data, true);
+    *center_x = out_w * 0.5f;
+    *center_y = out_h * 0.5f;
+
+    // Si la reducción es fuerte, se muestrea el mipmap más cercano (si está activo)
+    GE_Sprite* level = GE_SelectMipLevel(sprite, &src_x, &src_y, &src_w, &src_h, (int)(w + 0.5f), (int)(h + 0.5f));
+
+    // Píxel destino -> texel (relativo a la región): inversa de rotar y escalar
+    float ku = src_w / w, kv = src_h / h;
+    float du_dx = c * ku, dv_dx = -s * kv;
+    bool bilinear = (filter == GE_FILTER_BILINEAR);
+    bool premultiply = !GE_SpriteDataPremultiplied(level) && !GE_SpriteIsOpaque(level);
+    GE_BilinearChunk chunk;
+
+    for (int y = 0; y < out_h; y++) {
+        float ry = (float)y + 0.5f - *center_y;
+        float rx = 0.5f - *center_x;
+        float u = (c * rx + s * ry) * ku + src_w * 0.5f;
+        float v = (-s * rx + c * ry) * kv + src_h * 0.5f;
+        unsigned char* out = data + (size_t)y * out_w * 4;
+
+        for (int start = 0; start < out_w; start += GE_FILTER_CHUNK) {
+            int n = out_w - start < GE_FILTER_CHUNK ? out_w - start : GE_FILTER_CHUNK;
+            for (int k = 0; k < n; k++, u += du_dx, v += dv_dx) {
+                bool inside = u >= 0.0f && v >= 0.0f && u < (float)src_w && v < (float)src_h;
+                if (!bilinear) {
+                    if (!inside) continue; // Ya está a cero (transparente)
+                    int tx = src_x + (int)u, ty = src_y + (int)v;
+                    uint32_t texel = GE_FetchTexel(level, GE_TexelRowOrNull(level, ty), tx);
+                    memcpy(out + (start + k) * 4, &texel, 4);
+                    continue;
+                }
+                if (!inside) {
+                    chunk.tl[k] = chunk.tr[k] = chunk.bl[k] = chunk.br[k] = 0;
+                    chunk.fx[k] = chunk.fy[k] = 0;
+                    continue;
+                }
+                int x0, x1, y0, y1;
+                GE_FilterTaps((int)floorf((u - 0.5f) * 256.0f) + (src_x << 8), src_x, src_x + src_w - 1, &x0, &x1, &chunk.fx[k]);
+                GE_FilterTaps((int)floorf((v - 0.5f) * 256.0f) + (src_y << 8), src_y, src_y + src_h - 1, &y0, &y1, &chunk.fy[k]);
+                const unsigned char* row0 = GE_TexelRowOrNull(level, y0);
+                const unsigned char* row1 = GE_TexelRowOrNull(level, y1);
+                chunk.tl[k] = GE_FetchTexel(level, row0, x0);
+                chunk.tr[k] = GE_FetchTexel(level, row0, x1);
+                chunk.bl[k] = GE_FetchTexel(level, row1, x0);
+                chunk.br[k] = GE_FetchTexel(level, row1, x1);
+            }
+            if (bilinear) {
+                GE_BilinearResolve(&chunk, n, premultiply);
+                memcpy(out + start * 4, chunk.out, (size_t)n * 4);
+            }
+        }
+    }
+
+    image->premultiplied = bilinear || GE_SpriteDataPremultiplied(level);
+    GE_DetectOpaque(image);
+    return image;
+}
+
+void GE_DrawSpriteCached(GE_Context* ctx, GE_Sprite* sprite, GE_Rect src, GE_Point position, GE_Point origin,
+                         float rotation, float scale, GE_Color tint) {
+    if (!ctx || !ctx->render_buffer || !sprite || !sprite->data || scale <= 0.0f) return;
+
+    struct GE_TransformCache* cache = ctx->xform_cache;
+    if (!cache) {
+        // Sin caché: transformación exacta de siempre
+        GE_Rect dest = { position.x, position.y, src.w * scale, src.h * scale };
+        GE_DrawSpritePro(ctx, sprite, src, dest, origin, rotation, tint);
+        return;
+    }
+
+    // Región fuente recortada al sprite
+    int src_x = (int)src.x, src_y = (int)src.y;
+    int src_x1 = (int)(src.x + src.w), src_y1 = (int)(src.y + src.h);
+    if (src_x < 0) src_x = 0;
+    if (src_y < 0) src_y = 0;
+    if (src_x1 > sprite->width) src_x1 = sprite->width;
+    if (src_y1 > sprite->height) src_y1 = sprite->height;
+    int src_w = src_x1 - src_x, src_h = src_y1 - src_y;
+    if (src_w <= 0 || src_h <= 0) return;
+
+    // Cuantización
+    int angle_bucket = (int)floorf(rotation / 360.0f * GE_XFORM_ANGLE_STEPS + 0.5f) % GE_XFORM_ANGLE_STEPS;
+    if (angle_bucket < 0) angle_bucket += GE_XFORM_ANGLE_STEPS;
+    int scale_bucket = (int)floorf(scale * GE_XFORM_SCALE_STEPS + 0.5f);
+    if (scale_bucket < 1) scale_bucket = 1;
+    float q_angle = angle_bucket * (2.0f * 3.14159f / GE_XFORM_ANGLE_STEPS);
+    float q_scale = (float)scale_bucket / GE_XFORM_SCALE_STEPS;
+
+    uint32_t palette_serial = sprite->palette ? sprite->palette->serial : 0;
+    uint64_t pinned_pass = GE_TransformCachePin(ctx);
+    GE_TransformEntry* entry = NULL;
+    for (int i = 0; i < cache->count; i++) {
+        GE_TransformEntry* e = &cache->entries[i];
+        if (e->serial == sprite->serial && e->palette_serial == palette_serial && e->angle_bucket == angle_bucket && e->scale_bucket == scale_bucket &&
+            e->src_x == src_x && e->src_y == src_y && e->src_w == src_w && e->src_h == src_h &&
+            e->filter == ctx->texture_filter) {
+            entry = e;
+            break;
+        }
+    }
+
+    if (entry) {
+        cache->hits++;
+    } else {
+        cache->misses++;
+        float center_x, center_y;
+        GE_Sprite* image = GE_RenderTransformed(sprite, src_x, src_y, src_w, src_h, q_angle, q_scale,
+                                                ctx->texture_filter, &center_x, &center_y);
+        if (!image) return;
+
+        size_t bytes = (size_t)image->width * image->height * 4 + sizeof(GE_Sprite);
+        if (bytes > cache->budget && !pinned_pass) {
+            // Nunca cabría: se dibuja sin cachear (en una pasada diferida se guarda igualmente
+            // hasta dibujarla, para no alterar el orden; sale en la siguiente expulsión)
+            GE_FreeCachedImage(image);
+            GE_Rect dest = { position.x, position.y, src.w * scale, src.h * scale };
+            GE_DrawSpritePro(ctx, sprite, src, dest, origin, rotation, tint);
+            return;
+        }
+
+        // Expulsar libera imágenes que la cola del render multihilo aún puede leer
+        if (ctx->render_queue && cache->used + bytes > cache->budget) GE_FlushRendering(ctx);
+        GE_TrimTransformCache(cache, bytes, pinned_pass);
+        if (cache->count == cache->capacity) {
+            int new_cap = cache->capacity ? cache->capacity * 2 : 32;
+            GE_TransformEntry* list = (GE_TransformEntry*)realloc(cache->entries, new_cap * sizeof(GE_TransformEntry));
+            if (!list) { GE_FreeCachedImage(image); return; }
+            cache->entries = list;
+            cache->capacity = new_cap;
+        }
+
+        entry = &cache->entries[cache->count++];
+        entry->serial = sprite->serial;
+        entry->palette_serial = palette_serial;
+        entry->src_x = src_x;
+        entry->src_y = src_y;
+        entry->src_w = src_w;
+        entry->src_h = src_h;
+        entry->angle_bucket = angle_bucket;
+        entry->scale_bucket = scale_bucket;
+        entry->filter = ctx->texture_filter;
+        entry->image = image;
+        entry->center_x = center_x;
+        entry->center_y = center_y;
+        entry->bytes = bytes;
+        cache->used += bytes;
+    }
+    entry->last_used = ++cache->tick;
+    entry->pinned_pass = pinned_pass;
+
+    // El pivote (origin, en píxeles a la escala pedida) cae en 'position'; de ahí al centro
+    float k = q_scale / scale;
+    float lx = src_w * q_scale * 0.5f - origin.x * k;
+    float ly = src_h * q_scale * 0.5f - origin.y * k;
+    float c = cosf(q_angle), s = sinf(q_angle);
+    float cx = position.x + lx * c - ly * s;
+    float cy = position.y + lx * s + ly * c;
+
+    GE_Sprite* image = entry->image;
+    GE_Tint t = GE_MakeTint(tint);
+    GE_BlitSpriteRegion(ctx, image, 0, 0, image->width, image->height,
+                        (int)floorf(cx - entry->center_x + 0.5f), (int)floorf(cy - entry->center_y + 0.5f),
+                        image->width, image->height, GE_FLIP_NONE, &t);
+}
+
+// --- ATLAS DE TEXTURAS ---
+// Empaqueta muchas imágenes pequeñas en pocas páginas grandes (RGBA) con un empaquetador
+// "skyline": la página guarda el perfil superior de lo ya ocupado y cada imagen nueva
+// se apoya donde su borde inferior quede más bajo. Los sprites que devuelve el atlas son
+// vistas (data + pitch) dentro de una página: no tienen memoria propia.
+
+#define GE_ATLAS_PADDING 1 // Separación entre imágenes (evita que se mezclen al filtrar)
+
+typedef struct {
+    int x, y, width;
+} GE_SkylineNode;
+
+typedef struct {
+    unsigned char* pixels;
+    int width, height;
+    GE_SkylineNode* skyline; // Como máximo 'width' nodos
+    int skyline_count;
+} GE_AtlasPage;
+
+struct GE_Atlas {
+    int page_width, page_height;
+    GE_AtlasPage* pages;
+    int page_count;
+    GE_Sprite** sprites; // Vistas entregadas (se liberan con el atlas)
+    int sprite_count, sprite_capacity;
+};
+
+GE_Atlas* GE_CreateAtlas(int page_width, int page_height) {
+    if (page_width <= 0 || page_height <= 0) return NULL;
+    GE_Atlas* atlas = (GE_Atlas*)calloc(1, sizeof(GE_Atlas));
+    if (!atlas) return NULL;
+    atlas->page_width = page_width;
+    atlas->page_height = page_height;
+    return atlas;
+}
+
+static GE_AtlasPage* GE_AtlasNewPage(GE_Atlas* atlas, int width, int height) {
+    GE_AtlasPage* pages = (GE_AtlasPage*)realloc(atlas->pages, (atlas->page_count + 1) * sizeof(GE_AtlasPage));
+    if (!pages) return NULL;
+    atlas->pages = pages;
+
+    GE_AtlasPage* page = &pages[atlas->page_count];
+    page->pixels = (unsigned char*)calloc((size_t)width * height, 4);
+    page->skyline = (GE_SkylineNode*)malloc((width + 1) * sizeof(GE_SkylineNode));
+    if (!page->pixels || !page->skyline) {
+        free(page->pixels);
+        free(page->skyline);
+        return NULL;
+    }
+    page->width = width;
+    page->height = height;
+    page->skyline[0] = (GE_SkylineNode){ 0, 0, width };
+    page->skyline_count = 1;
+    atlas->page_count++;
+    return page;
+}
+
+// Altura a la que cabría un rect w x h apoyado desde el nodo 'index' (-1 si no cabe)
+static int GE_SkylineFit(const GE_AtlasPage* page, int index, int w, int h) {
+    int x = page->skyline[index].x;
+    if (x + w > page->width) return -1;
+
+    int y = page->skyline[index].y;
+    int width_left = w;
+    for (int i = index; width_left > 0; i++) {
+        if (page->skyline[i].y > y) y = page->skyline[i].y;
+        if (y + h > page->height) return -1;
+        width_left -= page->skyline[i].width;
+    }
+    return y;
+}
+
+// Busca sitio (bottom-left) y actualiza el perfil. Retorna false si la página está llena.
+static bool GE_SkylinePack(GE_AtlasPage* page, int w, int h, int* out_x, int* out_y) {
+    int best = -1, best_bottom = 0, best_width = 0, best_y = 0;
+    for (int i = 0; i < page->skyline_count; i++) {
+        int y = GE_SkylineFit(page, i, w, h);
+        if (y < 0) continue;
+        int bottom = y + h;
+        if (best < 0 || bottom < best_bottom || (bottom == best_bottom && page->skyline[i].width < best_width)) {
+            best = i;
+            best_bottom = bottom;
+            best_width = page->skyline[i].width;
+            best_y = y;
+        }
+    }
+    if (best < 0) return false;
+
+    *out_x = page->skyline[best].x;
+    *out_y = best_y;
+
+    // Insertar el nuevo tramo del perfil
+    GE_SkylineNode* sk = page->skyline;
+    memmove(&sk[best + 1], &sk[best], (page->skyline_count - best) * sizeof(GE_SkylineNode));
+    sk[best] = (GE_SkylineNode){ *out_x, best_y + h, w };
+    page->skyline_count++;
+
+    // Recortar los tramos que quedaron debajo del nuevo
+    for (int i = best + 1; i < page->skyline_count; i++) {
+        int prev_end = sk[i - 1].x + sk[i - 1].width;
+        if (sk[i].x >= prev_end) break;
+        int shrink = prev_end - sk[i].x;
+        sk[i].x += shrink;
+        sk[i].width -= shrink;
+        if (sk[i].width > 0) break;
+        memmove(&sk[i], &sk[i + 1], (page->skyline_count - i - 1) * sizeof(GE_SkylineNode));
+        page->skyline_count--;
+        i--;
+    }
+
+    // Fusionar tramos vecinos a la misma altura
+    for (int i = 0; i < page->skyline_count - 1; i++) {
+        if (sk[i].y == sk[i + 1].y) {
+            sk[i].width += sk[i + 1].width;
+            memmove(&sk[i + 1], &sk[i + 2], (page->skyline_count - i - 2) * sizeof(GE_SkylineNode));
+            page->skyline_count--;
+            i--;
+        }
+    }
+    return true;
+}
+
+// Caja mínima con alpha > 0. Retorna false si la imagen es totalmente transparente.
+static bool GE_FindOpaqueBounds(const unsigned char* rgba, int w, int h, int* bx, int* by, int* bw, int* bh) {
+    int x0 = w, y0 = h, x1 = -1, y1 = -1;
+    for (int y = 0; y < h; y++) {
+        const unsigned char* row = rgba + (size_t)y * w * 4;
+        for (int x = 0; x < w; x++) {
+            if (row[x * 4 + 3] == 0) continue;
+            if (x < x0) x0 = x;
+            if (x > x1) x1 = x;
+            if (y < y0) y0 = y;
+            y1 = y;
+        }
+    }
+    if (x1 < 0) return false;
+    *bx = x0; *by = y0; *bw = x1 - x0 + 1; *bh = y1 - y0 + 1;
+    return true;
+}
+
+GE_Sprite* GE_AtlasAddPixels(GE_Atlas* atlas, const unsigned char* rgba, int width, int height) {
+    if (!atlas || !rgba || width <= 0 || height <= 0) return NULL;
+
+    if (atlas->sprite_count == atlas->sprite_capacity) {
+        int new_cap = atlas->sprite_capacity ? atlas->sprite_capacity * 2 : 64;
+        GE_Sprite** list = (GE_Sprite**)realloc(atlas->sprites, new_cap * sizeof(GE_Sprite*));
+        if (!list) return NULL;
+        atlas->sprites = list;
+        atlas->sprite_capacity = new_cap;
+    }
+
+    GE_Sprite* spr = (GE_Sprite*)calloc(1, sizeof(GE_Sprite));
+    if (!spr) return NULL;
+    spr->width = width;
+    spr->height = height;
+    spr->channels = 4;
+    spr->owns_data = false;
+    spr->atlas_owned = true;
+    spr->serial = GE_NextSpriteSerial();
+
+    // 1. Recortar bordes transparentes: solo se empaqueta (y se dibuja) la zona visible
+    int bx, by, bw, bh;
+    if (!GE_FindOpaqueBounds(rgba, width, height, &bx, &by, &bw, &bh)) {
+        // Totalmente transparente: vista vacía, nunca pinta nada
+        spr->data = NULL;
+        atlas->sprites[atlas->sprite_count++] = spr;
+        return spr;
+    }
+
+    // 2. Buscar hueco en las páginas existentes; si no hay, abrir una nueva
+    int pw = bw + GE_ATLAS_PADDING, ph = bh + GE_ATLAS_PADDING;
+    GE_AtlasPage* page = NULL;
+    int px = 0, py = 0;
+    for (int i = 0; i < atlas->page_count && !page; i++) {
+        if (GE_SkylinePack(&atlas->pages[i], pw, ph, &px, &py)) page = &atlas->pages[i];
+    }
+    if (!page) {
+        // Las imágenes más grandes que una página reciben una página a su medida
+        int new_w = pw > atlas->page_width ? pw : atlas->page_width;
+        int new_h = ph > atlas->page_height ? ph : atlas->page_height;
+        page = GE_AtlasNewPage(atlas, new_w, new_h);
+        if (!page || !GE_SkylinePack(page, pw, ph, &px, &py)) {
+            printf("[GE] Error: No se pudo reservar pagina de atlas (%dx%d).\n", new_w, new_h);
+            free(spr);
+            return NULL;
+        }
+    }
+
+    // 3. Copiar filas a la página
+    int pitch = page->width * 4;
+    for (int y = 0; y < bh; y++) {
+        memcpy(page->pixels + (size_t)(py + y) * pitch + px * 4,
+               rgba + ((size_t)(by + y) * width + bx) * 4, (size_t)bw * 4);
+    }
+
+    spr->data = page->pixels + (size_t)py * pitch + px * 4;
+    spr->pitch = pitch;
+    spr->trim_x = bx;
+    spr->trim_y = by;
+    spr->trim_w = bw;
+    spr->trim_h = bh;
+    GE_DetectOpaque(spr);
+    atlas->sprites[atlas->sprite_count++] = spr;
+    return spr;
+}
+
+GE_Sprite* GE_AtlasAddImage(GE_Atlas* atlas, const char* filepath) {
+    if (!atlas) return NULL;
+
+    int w, h, channels;
+    unsigned char* data = stbi_load(filepath, &w, &h, &channels, 4);
+    if (!data) {
+        printf("[GE] Error cargando sprite: %s\n", filepath);
+        return NULL;
+    }
+
+    GE_Sprite* spr = GE_AtlasAddPixels(atlas, data, w, h);
+    stbi_image_free(data);
+    return spr;
+}
+
+int GE_GetAtlasPageCount(GE_Atlas* atlas) {
+    return atlas ? atlas->page_count : 0;
+}
+
+void GE_UnloadAtlas(GE_Atlas* atlas) {
+    if (!atlas) return;
+    for (int i = 0; i < atlas->sprite_count; i++) {
+        GE_FreeMipmaps(atlas->sprites[i]);
+        GE_FreeSpriteMask(atlas->sprites[i]);
+        free(atlas->sprites[i]);
+    }
+    for (int i = 0; i < atlas->page_count; i++) {
+        free(atlas->pages[i].pixels);
+        free(atlas->pages[i].skyline);
+    }
+    free(atlas->sprites);
+    free(atlas->pages);
+    free(atlas);
+}
+
+// --- SUB-SPRITES Y HOJAS DE SPRITES ---
+// Un sub-sprite es una vista (sin copia) de una región del padre: comparte sus píxeles,
+// así que el padre debe seguir vivo mientras se use. Una hoja de sprites guarda la tabla
+// de rectángulos de cada cuadro ya calculada (rejilla o empaquetada a mano).
+
+GE_Sprite* GE_CreateSubSprite(GE_Sprite* parent, GE_Rect region) {
+    if (!parent) return NULL;
+
+    int rx = (int)region.x, ry = (int)region.y;
+    int rw = (int)region.w, rh = (int)region.h;
+    if (rw <= 0 || rh <= 0) return NULL;
+
+    GE_Sprite* spr = (GE_Sprite*)calloc(1, sizeof(GE_Sprite));
+    if (!spr) return NULL;
+    spr->width = rw;
+    spr->height = rh;
+    spr->channels = parent->channels;
+    spr->pitch = parent->pitch;
+    spr->owns_data = false;
+    spr->serial = GE_NextSpriteSerial();
+    spr->palette = parent->palette; // Compartida hasta que la vista se recolorée
+    spr->owns_palette = false;
+
+    // Intersección entre la región y la zona almacenada del padre
+    int x0 = rx > parent->trim_x ? rx : parent->trim_x;
+    int y0 = ry > parent->trim_y ? ry : parent->trim_y;
+    int x1 = rx + rw < parent->trim_x + parent->trim_w ? rx + rw : parent->trim_x + parent->trim_w;
+    int y1 = ry + rh < parent->trim_y + parent->trim_h ? ry + rh : parent->trim_y + parent->trim_h;
+    if (!parent->data || x0 >= x1 || y0 >= y1) return spr; // Vista vacía (transparente)
+
+    spr->data = parent->data + (y0 - parent->trim_y) * parent->pitch + (x0 - parent->trim_x) * GE_TexelBytes(parent);
+    spr->trim_x = x0 - rx;
+    spr->trim_y = y0 - ry;
+    spr->trim_w = x1 - x0;
+    spr->trim_h = y1 - y0;
+    spr->parent = parent->parent ? parent->parent : parent;
+    if (parent->opaque) spr->opaque = true;
+    else GE_DetectOpaque(spr);
+    return spr;
+}
+
+struct GE_SpriteSheet {
+    GE_Sprite* sprite;
+    GE_Rect* frames;
+    int frame_count;
+};
+
+GE_SpriteSheet* GE_CreateSpriteSheetGrid(GE_Sprite* sprite, int frame_w, int frame_h, int margin, int spacing) {
+    if (!sprite || frame_w <= 0 || frame_h <= 0) return NULL;
+
+    // Cuántas celdas completas caben con margen exterior y separación entre celdas
+    int cols = (sprite->width - 2 * margin + spacing) / (frame_w + spacing);
+    int rows = (sprite->height - 2 * margin + spacing) / (frame_h + spacing);
+    if (cols <= 0 || rows <= 0) return NULL;
+
+    GE_SpriteSheet* sheet = (GE_SpriteSheet*)calloc(1, sizeof(GE_SpriteSheet));
+    if (!sheet) return NULL;
+    sheet->frames = (GE_Rect*)malloc(cols * rows * sizeof(GE_Rect));
+    if (!sheet->frames) { free(sheet); return NULL; }
+    sheet->sprite = sprite;
+    sheet->frame_count = cols * rows;
+
+    // Orden de lectura: filas de izquierda a derecha, de arriba a abajo
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            sheet->frames[r * cols + c] = (GE_Rect){
+                (float)(margin + c * (frame_w + spacing)),
+                (float)(margin + r * (frame_h + spacing)),
+                (float)frame_w, (float)frame_h
+            };
+        }
+    }
+    return sheet;
+}
+
+GE_SpriteSheet* GE_CreateSpriteSheetRects(GE_Sprite* sprite, const GE_Rect* frames, int count) {
+    if (!sprite || !frames || count <= 0) return NULL;
+
+    GE_SpriteSheet* sheet = (GE_SpriteSheet*)calloc(1, sizeof(GE_SpriteSheet));
+    if (!sheet) return NULL;
+    sheet->frames = (GE_Rect*)malloc(count * sizeof(GE_Rect));
+    if (!sheet->frames) { free(sheet); return NULL; }
+    memcpy(sheet->frames, frames, count * sizeof(GE_Rect));
+    sheet->sprite = sprite;
+    sheet->frame_count = count;
+    return sheet;
+}
+
+void GE_UnloadSpriteSheet(GE_SpriteSheet* sheet) {
+    if (sheet) {
+        free(sheet->frames);
+        free(sheet);
+    }
+}
+
+int GE_GetSpriteSheetFrameCount(GE_SpriteSheet* sheet) {
+    return sheet ? sheet->frame_count : 0;
+}
+
+GE_Rect GE_GetSpriteSheetFrame(GE_SpriteSheet* sheet, int frame) {
+    if (!sheet || frame < 0 || frame >= sheet->frame_count) return (GE_Rect){0, 0, 0, 0};
+    return sheet->frames[frame];
+}
+
+void GE_DrawSpriteSheetFrame(GE_Context* ctx, GE_SpriteSheet* sheet, int frame, float x, float y, int flip, GE_Color tint) {
+    if (!sheet || frame < 0 || frame >= sheet->frame_count) return;
+    GE_Rect src = sheet->frames[frame];
+    GE_Rect dest = { x, y, src.w, src.h };
+    GE_DrawSpriteFlipped(ctx, sheet->sprite, src, dest, flip, tint);
+}
+
+// --- SISTEMA DE ANIMACIÓN ---
+
+GE_Animation GE_CreateAnimation(GE_Sprite* sprite, int frame_w, int frame_h, float duration) {
+    GE_Animation anim = {0};
+    anim.sprite = sprite;
+    anim.frame_w = frame_w;
+    anim.frame_h = frame_h;
+    anim.frame_duration = duration;
+    
+    if (sprite && frame_w > 0 && frame_h > 0) {
+        // Rejilla completa (filas x columnas), no solo una tira horizontal.
+        // Las columnas se guardan para no recalcularlas en cada dibujo.
+        int cols = sprite->width / frame_w;
+        int rows = sprite->height / frame_h;
+        if (cols < 1) cols = 1;
+        if (rows < 1) rows = 1;
+        anim.columns = cols;
+        anim.start_frame = 0;
+        anim.end_frame = cols * rows - 1;
+    }
+    
+    anim.active = true;
+    anim.loop = true;
+    return anim;
+}
+
+// Animación sobre una hoja de sprites: los rects de cada cuadro ya vienen calculados
+GE_Animation GE_CreateAnimationFromSheet(GE_SpriteSheet* sheet, int start_frame, int end_frame, float duration) {
+    GE_Animation anim = {0};
+    // Rango vacío (o sin hoja): animación inactiva que no dibuja nada
+    if (!sheet || sheet->frame_count <= 0) return anim;
+    if (start_frame < 0) start_frame = 0;
+    if (start_frame >= sheet->frame_count) start_frame = sheet->frame_count - 1;
+    if (end_frame < start_frame) return anim;
+    if (end_frame >= sheet->frame_count) end_frame = sheet->frame_count - 1;
+
+    anim.sprite = sheet->sprite;
+    anim.sheet = sheet;
+    anim.frame_w = (int)sheet->frames[start_frame].w;
+    anim.frame_h = (int)sheet->frames[start_frame].h;
+    anim.start_frame = start_frame;
+    anim.end_frame = end_frame;
+    anim.current_frame = start_frame;
+    anim.frame_duration = duration;
+    anim.active = true;
+    anim.loop = true;
+    return anim;
+}
+
+void GE_UpdateAnimation(GE_Animation* anim, float dt) {
+    if (!anim || !anim->active) return;
+
+    anim->timer += dt;
+    if (anim->timer >= anim->frame_duration) {
+        anim->timer = 0;
+        anim->current_frame++;
+        
+        if (anim->current_frame > anim->end_frame) {
+            if (anim->loop) {
+                anim->current_frame = anim->start_frame;
+            } else {
+                anim->current_frame = anim->end_frame;
+                anim->active = false; // Detener si no es loop
+            }
+        }
+    }
+}
+
+void GE_DrawAnimation(GE_Context* ctx, GE_Animation* anim, float x, float y, bool flip_x, GE_Color tint) {
+    if (!anim || !anim->sprite) return;
+
+    GE_Rect src;
+    if (anim->sheet) {
+        // Tabla precalculada: una búsqueda, sin divisiones
+        if (anim->current_frame < 0 || anim->current_frame >= anim->sheet->frame_count) return;
+        src = anim->sheet->frames[anim->current_frame];
+    } else {
+        int cols = anim->columns > 0 ? anim->columns : 1;
+
+        // Calcular posición del frame en la textura
+        int col = anim->current_frame % cols;
+        int row = anim->current_frame / cols;
+        src = (GE_Rect){
+            (float)(col * anim->frame_w),
+            (float)(row * anim->frame_h),
+            (float)anim->frame_w,
+            (float)anim->frame_h
+        };
+    }
+
+    GE_Rect dest = { x, y, src.w, src.h };
+
+    // El espejo invierte la dirección de muestreo en el blitter (misma hoja, sin duplicar)
+    GE_DrawSpriteFlipped(ctx, anim->sprite, src, dest, flip_x ? GE_FLIP_X : GE_FLIP_NONE, tint);
+}
+
+// --- TILEMAPS ---
+// Rejilla de índices de tile sobre una hoja de sprites. El mapa se divide en bloques
+// (chunks) de ~GE_TILEMAP_CHUNK_PX píxeles que se componen una vez en un buffer propio,
+// ya en el formato del lienzo (0xAARRGGBB). Al dibujar solo se recorren los bloques
+// visibles y cada fila se copia por tramos precalculados: opacos con memcpy, vacíos se
+// saltan y solo los de alpha parcial se mezclan píxel a píxel. Cambiar un tile marca
+// su bloque como sucio y se recompone en el siguiente dibujo. Los bloques que llevan
+// más tiempo sin verse se liberan cuando se supera el presupuesto de memoria.
+
+#define GE_TILEMAP_CHUNK_PX 256
+#define GE_TILEMAP_DEFAULT_BUDGET ((size_t)16 * 1024 * 1024)
+
+// Tipos de tramo (2 bits altos) | longitud (30 bits bajos)
+enum { GE_RUN_CLEAR = 0, GE_RUN_OPAQUE = 1, GE_RUN_BLEND = 2 };
+#define GE_RUN_TYPE(r) ((r) >> 30)
+#define GE_RUN_LEN(r)  ((int)((r) & 0x3FFFFFFFu))
+
+typedef struct {
+    uint32_t* pixels;   // Compuesto ARGB (NULL = sin generar o liberado)
+    uint32_t* runs;     // Tramos de todas las filas seguidas
+    int* row_runs;      // Primer tramo de cada fila (alto + 1 entradas)
+    int width, height;  // En píxeles (los bloques del borde pueden ser menores)
+    bool dirty;
+    bool empty;         // Todo transparente: se salta sin mirar filas
+    uint64_t last_drawn;
+} GE_TileChunk;
+
+struct GE_Tilemap {
+    GE_SpriteSheet* tileset;
+    int columns, rows;
+    int tile_w, tile_h;
+    int16_t* tiles;     // -1 = vacío
+
+    int chunk_cols, chunk_rows; // Tiles por bloque
+    int chunks_x, chunks_y;     // Bloques del mapa
+    GE_TileChunk* chunks;
+
+    size_t budget, used;
+    uint64_t frame;
+};
+
+GE_Tilemap* GE_CreateTilemap(GE_SpriteSheet* tileset, int columns, int rows, int tile_w, int tile_h) {
+    if (!tileset || columns <= 0 || rows <= 0 || tile_w <= 0 || tile_h <= 0) return NULL;
+
+    GE_Tilemap* map = (GE_Tilemap*)calloc(1, sizeof(GE_Tilemap));
+    if (!map) return NULL;
+    map->tileset = tileset;
+    map->columns = columns;
+    map->rows = rows;
+    map->tile_w = tile_w;
+    map->tile_h = tile_h;
+    map->chunk_cols = GE_TILEMAP_CHUNK_PX / tile_w > 0 ? GE_TILEMAP_CHUNK_PX / tile_w : 1;
+    map->chunk_rows = GE_TILEMAP_CHUNK_PX / tile_h > 0 ? GE_TILEMAP_CHUNK_PX / tile_h : 1;
+    map->chunks_x = (columns + map->chunk_cols - 1) / map->chunk_cols;
+    map->chunks_y = (rows + map->chunk_rows - 1) / map->chunk_rows;
+    map->budget = GE_TILEMAP_DEFAULT_BUDGET;
+
+    map->tiles = (int16_t*)malloc((size_t)columns * rows * sizeof(int16_t));
+    map->chunks = (GE_TileChunk*)calloc((size_t)map->chunks_x * map->chunks_y, sizeof(GE_TileChunk));
+    if (!map->tiles || !map->chunks) {
+        printf("[GE] Error: Sin memoria para el tilemap (%dx%d)\n", columns, rows);
+        free(map->tiles);
+        free(map->chunks);
+        free(map);
+        return NULL;
+    }
+    for (int i = 0; i < columns * rows; i++) map->tiles[i] = -1;
+
+    for (int cy = 0; cy < map->chunks_y; cy++) {
+        for (int cx = 0; cx < map->chunks_x; cx++) {
+            GE_TileChunk* chunk = &map->chunks[cy * map->chunks_x + cx];
+            int cols = columns - cx * map->chunk_cols;
+            int rws = rows - cy * map->chunk_rows;
+            chunk->width = (cols < map->chunk_cols ? cols : map->chunk_cols) * tile_w;
+            chunk->height = (rws < map->chunk_rows ? rws : map->chunk_rows) * tile_h;
+            chunk->dirty = true;
+        }
+    }
+    return map;
+}
+
+static void GE_FreeTileChunk(GE_Tilemap* map, GE_TileChunk* chunk) {
+    if (!chunk->pixels) return;
+    map->used -= (size_t)chunk->width * chunk->height * sizeof(uint32_t);
+    free(chunk->pixels);
+    free(chunk->runs);
+    free(chunk->row_runs);
+    chunk->pixels = NULL;
+    chunk->runs = NULL;
+    chunk->row_runs = NULL;
+    chunk->dirty = true;
+}
+
+void GE_UnloadTilemap(GE_Tilemap* map) {
+    if (!map) return;
+    for (int i = 0; i < map->chunks_x * map->chunks_y; i++) GE_FreeTileChunk(map, &map->chunks[i]);
+    free(map->chunks);
+    free(map->tiles);
+    free(map);
+}
+
+void GE_SetTile(GE_Tilemap* map, int col, int row, int tile) {
+    if (!map || col < 0 || row < 0 || col >= map->columns || row >= map->rows) return;
+    int16_t value = (int16_t)(tile < 0 || tile > INT16_MAX ? -1 : tile);
+    int16_t* cell = &map->tiles[row * map->columns + col];
+    if (*cell == value) return;
+    *cell = value;
+    map->chunks[(row / map->chunk_rows) * map->chunks_x + col / map->chunk_cols].dirty = true;
+}
+
+int GE_GetTile(GE_Tilemap* map, int col, int row) {
+    if (!map || col < 0 || row < 0 || col >= map->columns || row >= map->rows) return -1;
+    return map->tiles[row * map->columns + col];
+}
+
+void GE_SetTilemapData(GE_Tilemap* map, const int* tiles) {
+    if (!map || !tiles) return;
+    for (int row = 0; row < map->rows; row++) {
+        for (int col = 0; col < map->columns; col++) GE_SetTile(map, col, row, tiles[row * map->columns + col]);
+    }
+}
+
+void GE_InvalidateTilemap(GE_Tilemap* map) {
+    if (!map) return;
+    for (int i = 0; i < map->chunks_x * map->chunks_y; i++) map->chunks[i].dirty = true;
+}
+
+void GE_SetTilemapCacheBudget(GE_Tilemap* map, size_t budget_bytes) {
+    if (map) map->budget = budget_bytes;
+}
+
+// Compone los tiles del bloque (cx, cy) y precalcula los tramos de cada fila
+static bool GE_BuildTileChunk(GE_Tilemap* map, GE_TileChunk* chunk, int cx, int cy) {
+    size_t pixel_count = (size_t)chunk->width * chunk->height;
+    if (!chunk->pixels) {
+        chunk->pixels = (uint32_t*)malloc(pixel_count * sizeof(uint32_t));
+        chunk->row_runs = (int*)malloc((chunk->height + 1) * sizeof(int));
+        if (!chunk->pixels || !chunk->row_runs) {
+            free(chunk->pixels);
+            free(chunk->row_runs);
+            chunk->pixels = NULL;
+            chunk->row_runs = NULL;
+            return false;
+        }
+        map->used += pixel_count * sizeof(uint32_t);
+    }
+    memset(chunk->pixels, 0, pixel_count * sizeof(uint32_t));
+
+    // 1. Tiles -> píxeles ARGB (alpha y premultiplicación tal cual los tiene la hoja)
+    GE_SpriteSheet* sheet = map->tileset;
+    GE_Sprite* sprite = sheet->sprite;
+    int col0 = cx * map->chunk_cols, row0 = cy * map->chunk_rows;
+    int cols = chunk->width / map->tile_w, rows = chunk->height / map->tile_h;
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            int tile = map->tiles[(row0 + r) * map->columns + col0 + c];
+            if (tile < 0 || tile >= sheet->frame_count || !sprite->data) continue;
+            GE_Rect frame = sheet->frames[tile];
+            int fx = (int)frame.x, fy = (int)frame.y;
+            int w = (int)frame.w < map->tile_w ? (int)frame.w : map->tile_w;
+            int h = (int)frame.h < map->tile_h ? (int)frame.h : map->tile_h;
+            for (int y = 0; y < h; y++) {
+                const unsigned char* src_row = GE_TexelRowOrNull(sprite, fy + y);
+                if (!src_row) continue;
+                uint32_t* dst = chunk->pixels + (size_t)(r * map->tile_h + y) * chunk->width + c * map->tile_w;
+                for (int x = 0; x < w; x++) {
+                    uint32_t texel = GE_FetchTexel(sprite, src_row, fx + x);
+                    const unsigned char* px = (const unsigned char*)&texel;
+                    dst[x] = ((uint32_t)px[3] << 24) | ((uint32_t)px[0] << 16) | ((uint32_t)px[1] << 8) | px[2];
+                }
+            }
+        }
+    }
+
+    // 2. Tramos. Dos pasadas: contar y luego escribir (una sola reserva)
+    int run_count = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        int n = 0;
+        for (int y = 0; y < chunk->height; y++) {
+            const uint32_t* row = chunk->pixels + (size_t)y * chunk->width;
+            if (pass) chunk->row_runs[y] = n;
+            int x = 0;
+            while (x < chunk->width) {
+                uint32_t a = row[x] >> 24;
+                uint32_t type = a == 0 ? GE_RUN_CLEAR : (a == 255 ? GE_RUN_OPAQUE : GE_RUN_BLEND);
+                int start = x;
+                while (x < chunk->width) {
+                    uint32_t b = row[x] >> 24;
+                    if ((b == 0 ? GE_RUN_CLEAR : (b == 255 ? GE_RUN_OPAQUE : GE_RUN_BLEND)) != type) break;
+                    x++;
+                }
+                if (pass) chunk->runs[n] = (type << 30) | (uint32_t)(x - start);
+                n++;
+            }
+        }
+        if (pass) {
+            chunk->row_runs[chunk->height] = n;
+        } else {
+            run_count = n;
+            uint32_t* runs = (uint32_t*)realloc(chunk->runs, (run_count ? run_count : 1) * sizeof(uint32_t));
+            if (!runs) return false;
+            chunk->runs = runs;
+        }
+    }
+
+    chunk->empty = true;
+    for (int i = 0; i < run_count; i++) {
+        if (GE_RUN_TYPE(chunk->runs[i]) != GE_RUN_CLEAR) { chunk->empty = false; break; }
+    }
+    chunk->dirty = false;
+    return true;
+}
+
+// Mezcla de un tramo ARGB (alpha recto o premultiplicado) con el modo activo
+typedef void (*GE_ChunkBlendFn)(uint32_t* dst, const uint32_t* src, int count);
+
+#define GE_DEFINE_CHUNK_BLEND(NAME, STORE) \
+static void NAME(uint32_t* dst, const uint32_t* src, int count) { \
+    for (int i = 0; i < count; i++) { \
+        uint32_t p = src[i], a = p >> 24; \
+        if (a == 0) continue; \
+        uint32_t r = (p >> 16) & 0xFF, g = (p >> 8) & 0xFF, b = p & 0xFF; \
+        STORE(&dst[i], r, g, b, a); \
+    } \
+}
+
+GE_DEFINE_CHUNK_BLEND(GE_ChunkBlend_Over,         GE_STORE_ALPHA)
+GE_DEFINE_CHUNK_BLEND(GE_ChunkBlend_Add,          GE_STORE_ADD)
+GE_DEFINE_CHUNK_BLEND(GE_ChunkBlend_Mul,          GE_STORE_MULTIPLY)
+GE_DEFINE_CHUNK_BLEND(GE_ChunkBlend_Screen,       GE_STORE_SCREEN)
+GE_DEFINE_CHUNK_BLEND(GE_ChunkBlend_OverPremul,   GE_STORE_PREMUL)
+GE_DEFINE_CHUNK_BLEND(GE_ChunkBlend_AddPremul,    GE_OP_ADD)
+GE_DEFINE_CHUNK_BLEND(GE_ChunkBlend_MulPremul,    GE_OP_MULTIPLY)
+GE_DEFINE_CHUNK_BLEND(GE_ChunkBlend_ScreenPremul, GE_OP_SCREEN)
+GE_DEFINE_CHUNK_BLEND(GE_ChunkBlend_Copy,         GE_STORE_OPAQUE)
+GE_DEFINE_CHUNK_BLEND(GE_ChunkBlend_CopyPremul,   GE_STORE_UNPREMUL)
+
+// [modo][premultiplicado]
+static const GE_ChunkBlendFn g_chunk_blend_table[GE_BLEND_MODE_COUNT][2] = {
+    { GE_ChunkBlend_Over,   GE_ChunkBlend_OverPremul   },
+    { GE_ChunkBlend_Add,    GE_ChunkBlend_AddPremul    },
+    { GE_ChunkBlend_Mul,    GE_ChunkBlend_MulPremul    },
+    { GE_ChunkBlend_Screen, GE_ChunkBlend_ScreenPremul },
+    { GE_ChunkBlend_Copy,   GE_ChunkBlend_CopyPremul   }
+};
+
+// Libera los bloques vistos hace más tiempo hasta volver al presupuesto (nunca los de este frame)
+static void GE_TrimTilemapCache(GE_Tilemap* map) {
+    while (map->used > map->budget) {
+        GE_TileChunk* oldest = NULL;
+        for (int i = 0; i < map->chunks_x * map->chunks_y; i++) {
+            GE_TileChunk* chunk = &map->chunks[i];
+            if (!chunk->pixels || chunk->last_drawn == map->frame) continue;
+            if (!oldest || chunk->last_drawn < oldest->last_drawn) oldest = chunk;
+        }
+        if (!oldest) return;
+        GE_FreeTileChunk(map, oldest);
+    }
+}
+
+void GE_DrawTilemap(GE_Context* ctx, GE_Tilemap* map, float x, float y) {
+    if (!ctx || !ctx->render_buffer || !map) return;
+    GE_FlushRendering(ctx); // Los bloques se copian en el hilo principal, tras lo grabado
+    map->frame++;
+
+    // Rango visible en píxeles del mapa
+    int ox = (int)floorf(x), oy = (int)floorf(y);
+    int map_w = map->columns * map->tile_w, map_h = map->rows * map->tile_h;
+    int vx0 = -ox > 0 ? -ox : 0, vy0 = -oy > 0 ? -oy : 0;
+    int vx1 = ctx->render_width - ox < map_w ? ctx->render_width - ox : map_w;
+    int vy1 = ctx->render_height - oy < map_h ? ctx->render_height - oy : map_h;
+    if (vx0 >= vx1 || vy0 >= vy1) return;
+
+    int chunk_pw = map->chunk_cols * map->tile_w, chunk_ph = map->chunk_rows * map->tile_h;
+    GE_BlendMode mode = ctx->blend_mode;
+    bool copy_opaque = (mode == GE_BLEND_ALPHA || mode == GE_BLEND_REPLACE);
+    GE_ChunkBlendFn blend = g_chunk_blend_table[mode][GE_SpriteDataPremultiplied(map->tileset->sprite) ? 1 : 0];
+
+    for (int cy = vy0 / chunk_ph; cy <= (vy1 - 1) / chunk_ph; cy++) {
+        for (int cx = vx0 / chunk_pw; cx <= (vx1 - 1) / chunk_pw; cx++) {
+            GE_TileChunk* chunk = &map->chunks[cy * map->chunks_x + cx];
+            if (chunk->dirty && !GE_BuildTileChunk(map, chunk, cx, cy)) continue;
+            chunk->last_drawn = map->frame;
+            if (chunk->empty) continue;
+
+            // Parte visible del bloque, en coordenadas del bloque
+            int base_x = cx * chunk_pw, base_y = cy * chunk_ph;
+            int lx0 = vx0 - base_x > 0 ? vx0 - base_x : 0;
+            int ly0 = vy0 - base_y > 0 ? vy0 - base_y : 0;
+            int lx1 = vx1 - base_x < chunk->width ? vx1 - base_x : chunk->width;
+            int ly1 = vy1 - base_y < chunk->height ? vy1 - base_y : chunk->height;
+
+            for (int ly = ly0; ly < ly1; ly++) {
+                const uint32_t* src = chunk->pixels + (size_t)ly * chunk->width;
+                uint32_t* dst = ctx->render_buffer + (size_t)(oy + base_y + ly) * ctx->render_width + ox + base_x;
+                int run = chunk->row_runs[ly], run_end = chunk->row_runs[ly + 1];
+                for (int start = 0; run < run_end && start < lx1; run++) {
+                    uint32_t r = chunk->runs[run];
+                    int end = start + GE_RUN_LEN(r);
+                    int a = start > lx0 ? start : lx0;
+                    int b = end < lx1 ? end : lx1;
+                    if (a < b) {
+                        uint32_t type = GE_RUN_TYPE(r);
+                        if (type == GE_RUN_OPAQUE && copy_opaque) memcpy(dst + a, src + a, (size_t)(b - a) * sizeof(uint32_t));
+                        else if (type != GE_RUN_CLEAR) blend(dst + a, src + a, b - a);
+                    }
+                    start = end;
+                }
+            }
+        }
+    }
+
+    GE_TrimTilemapCache(map);
+}
+
+// --- CAPAS ---
+// Cada capa tiene un buffer del tamaño del lienzo que conserva su contenido entre
+// frames: solo se redibuja cuando está sucia. GE_BeginLayer redirige render_buffer a
+// la capa, así que todas las funciones de dibujo funcionan sin cambios. Las capas
+// transparentes empiezan vacías (0) y, como GE_STORE_ALPHA acumula la cobertura en
+// el alpha del destino, terminan en ARGB premultiplicado. La composición recorre el
+// lienzo una vez, fila a fila: parte de la capa opaca visible más alta (se copia; lo
+// que queda debajo no se toca) y mezcla encima el resto con el núcleo SIMD, saltando
+// bloques vacíos y copiando los opacos.
+
+#ifdef GE_SIMD_LANES
+// Capa premultiplicada sobre el lienzo. Retorna cuántos píxeles procesó.
+#define GE_DEFINE_SIMD_COMPOSE(NAME, MODE) \
+static int NAME(uint32_t* dst, const uint32_t* src, int count) { \
+    const GE_Vec zero = GE_V_ZERO(); \
+    const GE_Vec alpha_mask = GE_V_SET32(0xFF000000u); \
+    int n = count & ~(GE_SIMD_LANES - 1); \
+    for (int i = 0; i < n; i += GE_SIMD_LANES) { \
+        GE_Vec sv = GE_V_LOAD(src + i); \
+        GE_Vec skip = GE_V_CMPEQ32(sv, zero); \
+        if (GE_V_MOVEMASK8(skip) == GE_V_MASK_ALL) continue; \
+        if ((MODE) == GE_BLEND_ALPHA && \
+            GE_V_MOVEMASK8(GE_V_CMPEQ32(GE_V_AND(sv, alpha_mask), alpha_mask)) == GE_V_MASK_ALL) { \
+            GE_V_STORE(dst + i, sv); \
+            continue; \
+        } \
+        GE_Vec dv = GE_V_LOAD(dst + i); \
+        GE_Vec slo = GE_V_UNPACKLO8(sv, zero), shi = GE_V_UNPACKHI8(sv, zero); \
+        GE_Vec dlo = GE_V_UNPACKLO8(dv, zero), dhi = GE_V_UNPACKHI8(dv, zero), rlo, rhi; \
+        GE_V_BLEND(MODE, 1, slo, dlo, rlo); \
+        GE_V_BLEND(MODE, 1, shi, dhi, rhi); \
+        /* Píxeles vacíos de la capa dejan el lienzo intacto (igual que el escalar) */ \
+        GE_Vec res = GE_V_OR(GE_V_PACKUS16(rlo, rhi), alpha_mask); \
+        GE_V_STORE(dst + i, GE_V_OR(GE_V_AND(skip, dv), GE_V_ANDNOT(skip, res))); \
+    } \
+    return n; \
+}
+
+GE_DEFINE_SIMD_COMPOSE(GE_SimdCompose_Over, GE_BLEND_ALPHA)
+GE_DEFINE_SIMD_COMPOSE(GE_SimdCompose_Add,  GE_BLEND_ADDITIVE)
+#endif
+
+// Mezcla 'count' píxeles de una fila de capa sobre el lienzo (que queda opaco)
+static void GE_ComposeSpan(uint32_t* dst, const uint32_t* src, int count, GE_BlendMode mode) {
+    int done = 0;
+#ifdef GE_SIMD_LANES
+    done = (mode == GE_BLEND_ADDITIVE ? GE_SimdCompose_Add : GE_SimdCompose_Over)(dst, src, count);
+#endif
+    for (int i = done; i < count; i++) {
+        uint32_t c = src[i];
+        if (c == 0) continue;
+        uint32_t a = c >> 24, r = (c >> 16) & 0xFF, g = (c >> 8) & 0xFF, b = c & 0xFF;
+        if (mode == GE_BLEND_ADDITIVE) GE_OP_ADD(&dst[i], r, g, b, a);
+        else if (a == 255) dst[i] = c;
+        else GE_STORE_PREMUL(&dst[i], r, g, b, a);
+        dst[i] |= 0xFF000000u;
+    }
+}
+
+// Una fila de la capa con su desplazamiento cíclico: dos tramos contiguos de origen
+static void GE_ComposeLayerRow(GE_Layer* layer, uint32_t* dst, int y, bool copy) {
+    int w = layer->width;
+    int sy = ((y - layer->scroll_y) % layer->height + layer->height) % layer->height;
+    int sx = ((-layer->scroll_x) % w + w) % w;
+    const uint32_t* src = layer->pixels + (size_t)sy * w;
+    if (copy) {
+        memcpy(dst, src + sx, (size_t)(w - sx) * sizeof(uint32_t));
+        memcpy(dst + (w - sx), src, (size_t)sx * sizeof(uint32_t));
+    } else {
+        GE_ComposeSpan(dst, src + sx, w - sx, layer->blend);
+        GE_ComposeSpan(dst + (w - sx), src, sx, layer->blend);
+    }
+}
+
+GE_Layer* GE_CreateLayer(GE_Context* ctx, int z, bool opaque) {
+    if (!ctx || ctx->render_width <= 0 || ctx->render_height <= 0) return NULL;
+
+    if (ctx->layer_count == ctx->layer_capacity) {
+        int new_cap = ctx->layer_capacity ? ctx->layer_capacity * 2 : 8;
+        GE_Layer** list = (GE_Layer**)realloc(ctx->layers, new_cap * sizeof(GE_Layer*));
+        if (!list) return NULL;
+        ctx->layers = list;
+        ctx->layer_capacity = new_cap;
+    }
+
+    GE_Layer* layer = (GE_Layer*)calloc(1, sizeof(GE_Layer));
+    if (!layer) return NULL;
+    size_t count = (size_t)ctx->render_width * ctx->render_height;
+    layer->pixels = (uint32_t*)calloc(count, sizeof(uint32_t));
+    if (!layer->pixels) {
+        printf("[GE] Error: Sin memoria para una capa de %dx%d\n", ctx->render_width, ctx->render_height);
+        free(layer);
+        return NULL;
+    }
+    if (opaque) {
+        for (size_t i = 0; i < count; i++) layer->pixels[i] = 0xFF000000u;
+    }
+    layer->ctx = ctx;
+    layer->width = ctx->render_width;
+    layer->height = ctx->render_height;
+    layer->z = z;
+    layer->opaque = opaque;
+    layer->dirty = true;
+    layer->visible = true;
+    layer->blend = GE_BLEND_ALPHA;
+
+    // Inserción estable: a igual z, la más nueva queda encima
+    int pos = ctx->layer_count;
+    while (pos > 0 && ctx->layers[pos - 1]->z > z) {
+        ctx->layers[pos] = ctx->layers[pos - 1];
+        pos--;
+    }
+    ctx->layers[pos] = layer;
+    ctx->layer_count++;
+    return layer;
+}
+
+void GE_UnloadLayer(GE_Layer* layer) {
+    if (!layer) return;
+    GE_Context* ctx = layer->ctx;
+    if (ctx) {
+        if (ctx->active_layer == layer) GE_EndLayer(ctx);
+        GE_FlushRendering(ctx); // Puede haber dibujos grabados sobre esta capa
+        for (int i = 0; i < ctx->layer_count; i++) {
+            if (ctx->layers[i] != layer) continue;
+            memmove(&ctx->layers[i], &ctx->layers[i + 1], (ctx->layer_count - i - 1) * sizeof(GE_Layer*));
+            ctx->layer_count--;
+            break;
+        }
+    }
+    free(layer->pixels);
+    free(layer);
+}
+
+bool GE_BeginLayer(GE_Context* ctx, GE_Layer* layer) {
+    if (!ctx || !layer || layer->ctx != ctx) return false;
+    if (ctx->active_layer) {
+        printf("[GE] Error: GE_BeginLayer con otra capa activa (falta GE_EndLayer)\n");
+        return false;
+    }
+    if (ctx->deferred && ctx->deferred->recording) {
+        printf("[GE] Error: GE_BeginLayer dentro de una pasada diferida\n");
+        return false;
+    }
+    if (!layer->dirty) return false;
+
+    ctx->screen_buffer = ctx->render_buffer;
+    ctx->render_buffer = layer->pixels;
+    ctx->active_layer = layer;
+    if (!layer->opaque) GE_Clear(ctx, 0); // Grabado si el render es multihilo
+    return true;
+}
+
+void GE_EndLayer(GE_Context* ctx) {
+    if (!ctx || !ctx->active_layer) return;
+    // Lo grabado en una pasada diferida abierta pertenece a esta capa
+    GE_EndDeferredSprites(ctx);
+    ctx->active_layer->dirty = false;
+    ctx->render_buffer = ctx->screen_buffer;
+    ctx->screen_buffer = NULL;
+    ctx->active_layer = NULL;
+}
+
+void GE_MarkLayerDirty(GE_Layer* layer) {
+    if (layer) layer->dirty = true;
+}
+
+bool GE_IsLayerDirty(GE_Layer* layer) {
+    return layer ? layer->dirty : false;
+}
+
+void GE_SetLayerVisible(GE_Layer* layer, bool visible) {
+    if (layer) layer->visible = visible;
+}
+
+void GE_SetLayerBlendMode(GE_Layer* layer, GE_BlendMode mode) {
+    if (layer) layer->blend = (mode == GE_BLEND_ADDITIVE) ? GE_BLEND_ADDITIVE : GE_BLEND_ALPHA;
+}
+
+void GE_SetLayerScroll(GE_Layer* layer, float x, float y) {
+    if (!layer) return;
+    layer->scroll_x = (int)floorf(x);
+    layer->scroll_y = (int)floorf(y);
+}
+
+void GE_ComposeLayers(GE_Context* ctx) {
+    if (!ctx || ctx->layers_composed) return;
+    if (ctx->active_layer) {
+        printf("[GE] Error: Componiendo capas con una capa activa (falta GE_EndLayer)\n");
+        GE_EndLayer(ctx);
+    }
+    GE_FlushRendering(ctx);
+    ctx->layers_composed = true;
+
+    // La capa opaca visible más alta tapa el lienzo y todo lo que tenga debajo
+    int first = 0;
+    bool copy_first = false;
+    for (int i = ctx->layer_count - 1; i >= 0; i--) {
+        GE_Layer* layer = ctx->layers[i];
+        if (layer->visible && layer->opaque && layer->blend == GE_BLEND_ALPHA) {
+            first = i;
+            copy_first = true;
+            break;
+        }
+    }
+
+    for (int y = 0; y < ctx->render_height; y++) {
+        uint32_t* dst = ctx->render_buffer + (size_t)y * ctx->render_width;
+        for (int i = first; i < ctx->layer_count; i++) {
+            GE_Layer* layer = ctx->layers[i];
+            if (!layer->visible || layer->width != ctx->render_width || layer->height != ctx->render_height) continue;
+            GE_ComposeLayerRow(layer, dst, y, copy_first && i == first);
+        }
+    }
+}
+
+//int GE_GetSpriteWidth(GE_Sprite* sprite) { return sprite ? sprite->width : 0; }
+//int GE_GetSpriteHeight(GE_Sprite* sprite) { return sprite ? sprite->height : 0; }
+
+// ============================================================================
 // 7. IMPLEMENTACIÓN DE TEXTO (STB_TRUETYPE)
 // ============================================================================
 
-/*
+/*
+struct GE_Font {
+    stbtt_bakedchar cdata[96]; // Información de caracteres ASCII 32..126
+    GE_Sprite* texture;        // El atlas de la fuente convertido a Sprite
+    float size;
+};
+
+GE_Font* GE_LoadFont(const char* filepath, float size) {
+    // 1. Leer el archivo .ttf completo a memoria
+    FILE* f = fopen(filepath, "rb");
+    if (!f) {
+        printf("[GE] Error: No se pudo abrir la fuente '%s'\n", filepath);
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long fsize = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    unsigned char* ttf_buffer = (unsigned char*)malloc(fsize);
+    fread(ttf_buffer, 1, fsize, f);
+    fclose(f);
+
+    // 2. Crear un bitmap temporal para el "Atlas" de la fuente
+    int width = 512;
+    int height = 512;
+    unsigned char* temp_bitmap = (unsigned char*)malloc(width * height);
+
+    GE_Font* font = (GE_Font*)calloc(1, sizeof(GE_Font));
+    font->size = size;
+
+    // 3. "Hornear" (Bake) los caracteres al bitmap
+    // Esto dibuja todas las letras en una sola imagen en blanco y negro
+    stbtt_BakeFontBitmap(ttf_buffer, 0, size, temp_bitmap, width, height, 32, 96, font->cdata);
+    
+    free(ttf_buffer); // Ya no necesitamos el archivo original
+
+    // 4. Convertir el bitmap de 1 canal (Gris) a nuestro formato de Sprite (RGBA)
+    font->texture = (GE_Sprite*)malloc(sizeof(GE_Sprite));
+    font->texture->width = width;
+    font->texture->height = height;
+    font->texture->channels = 4;
+    font->texture->data = (unsigned char*)malloc(width * height * 4);
+
+    for (int i = 0; i < width * height; i++) {
+        uint8_t value = temp_bitmap[i];
+        // Lo convertimos a blanco puro, usando el valor como Alpha
+        font->texture->data[i*4 + 0] = 255; // R
+        font->texture->data[i*4 + 1] = 255; // G
+        font->texture->data[i*4 + 2] = 255; // B
+        font->texture->data[i*4 + 3] = value; // Alpha
+    }
+
+    free(temp_bitmap);
+    return font;
+}
+
+void GE_UnloadFont(GE_Font* font) {
+    if (font) {
+        if (font->texture) GE_UnloadSprite(font->texture);
+        free(font);
+    }
+}
+
+void GE_DrawText(GE_Context* ctx, GE_Font* font, const char* text, float x, float y, GE_Color color) {
+    if (!font || !text) return;
+
+    // Extraer componentes del color para tintar
+    // (Aprovechamos que GE_DrawSpriteEx ya soporta tintes)
+    
+    float startX = x;
+
+    while (*text) {
+        if (*text >= 32 && *text < 128) {
+            stbtt_aligned_quad q;
+            // Obtener coordenadas del caracter dentro del atlas
+            stbtt_GetBakedQuad(font->cdata, 512, 512, *text - 32, &x, &y, &q, 1);
+            
+            // Convertir coordenadas de Quad a Rect
+            GE_Rect src = { q.s0 * 512, q.t0 * 512, (q.s1 - q.s0) * 512, (q.t1 - q.t0) * 512 };
+            GE_Rect dst = { q.x0, q.y0, q.x1 - q.x0, q.y1 - q.y0 };
+
+            // Dibujar la letra usando nuestro sistema de Sprites existente
+            GE_DrawSpriteEx(ctx, font->texture, src, dst, color);
+        }
+        text++;
+    }
+}
+
+
+GE_Point GE_MeasureText(GE_Font* font, const char* text) {
+    if (!font || !text) return (GE_Point){0,0};
+    
+    float x = 0;
+    float y = 0;
+    
+    // Recorremos el texto char a char
+    const char* ptr = text;
+    while (*ptr) {
+        if (*ptr >= 32 && *ptr < 128) {
+            stbtt_aligned_quad q;
+            // GetBakedQuad avanza la variable 'x' automáticamente
+            stbtt_GetBakedQuad(font->cdata, 512, 512, *ptr - 32, &x, &y, &q, 1);
+        }
+        ptr++;
+    }
+    
+    // x ahora contiene el ancho total del texto
+    // Asumimos una altura estándar basada en el tamaño de fuente (aprox)
+    return (GE_Point){ x, 32.0f }; 
+}
+
+// Stub para alineación (puedes implementarlo calculando MeasureText primero)
+void GE_DrawTextAligned(GE_Context* c, GE_Font* f, const char* t, float x, float y, GE_TextAlign align, GE_Color col) {
+    if (!c || !f || !t) return;
+
+    // 1. Si es alineación izquierda, dibujamos normal y salimos (ahorra cálculos)
+    if (align == GE_ALIGN_LEFT) {
+        GE_DrawText(c, f, t, x, y, col);
+        return;
+    }
+
+    // 2. Medimos el ancho del texto
+    GE_Point size = GE_MeasureText(f, t);
+    
+    // 3. Ajustamos la posición X según la alineación
+    float finalX = x;
+    
+    if (align == GE_ALIGN_CENTER) {
+        finalX = x - (size.x / 2.0f); // Restamos la mitad del ancho
+    } 
+    else if (align == GE_ALIGN_RIGHT) {
+        finalX = x - size.x;          // Restamos todo el ancho
+    }
+    
+    // 4. Dibujamos en la nueva posición calculada
+    GE_DrawText(c, f, t, finalX, y, col);
+}
+
+*/
+
+
+// ============================================================================
+// 8. IMPLEMENTACIÓN DE AUDIO (MINIAUDIO)
+// ============================================================================
+
+// Estructura interna para manejar el motor de audio global
+// Usamos una variable global estática para el motor porque miniaudio lo requiere
+static ma_engine g_audioEngine;
+static bool g_audioInitialized = false;
+
+// Función interna para iniciar el motor si no está iniciado
+static void GE_InitAudioSystem() {
+    if (!g_audioInitialized) {
+        if (ma_engine_init(NULL, &g_audioEngine) == MA_SUCCESS) {
+            g_audioInitialized = true;
+            printf("[GE] Sistema de Audio Inicializado.\n");
+        } else {
+            printf("[GE] Error: Fallo al iniciar Audio.\n");
+        }
+    }
+}
+
+struct GE_Sound {
+    ma_sound sound; // Objeto de sonido de miniaudio
+    bool loaded;
+};
+
+GE_Sound* GE_LoadSound(const char* filepath) {
+    GE_InitAudioSystem(); // Asegurar que el sistema existe
+    if (!g_audioInitialized) return NULL;
+
+    GE_Sound* s = (GE_Sound*)malloc(sizeof(GE_Sound));
+    
+    // Cargar sonido decodificándolo directamente (Stream es mejor para música, Decode para SFX)
+    // Aquí usamos MA_SOUND_FLAG_DECODE para cargarlo en RAM (mejor para efectos cortos)
+    ma_result result = ma_sound_init_from_file(&g_audioEngine, filepath, MA_SOUND_FLAG_DECODE, NULL, NULL, &s->sound);
+    
+    if (result != MA_SUCCESS) {
+        printf("[GE] Error cargando sonido: %s\n", filepath);
+        free(s);
+        return NULL;
+    }
+    
+    s->loaded = true;
+    return s;
+}
+
+void GE_UnloadSound(GE_Sound* sound) {
+    if (sound && sound->loaded) {
+        ma_sound_uninit(&sound->sound);
+        free(sound);
+    }
+}
+
+void GE_PlaySound(GE_Sound* sound) {
+    if (sound && sound->loaded) {
+        // Si ya está sonando, lo reiniciamos (para disparos rápidos)
+        if (ma_sound_is_playing(&sound->sound)) {
+            ma_sound_seek_to_pcm_frame(&sound->sound, 0);
+        }
+        ma_sound_start(&sound->sound);
+    }
+}
+
+void GE_StopSound(GE_Sound* sound) {
+    if (sound && sound->loaded) {
+        ma_sound_stop(&sound->sound);
+        ma_sound_seek_to_pcm_frame(&sound->sound, 0); // Rebobinar al inicio
+    }
+}
+
+void GE_SetVolume(GE_Sound* sound, float volume) {
+    if (sound && sound->loaded) {
+        ma_sound_set_volume(&sound->sound, volume);
+    }
+}
+
+void GE_SetLooping(GE_Sound* sound, bool loop) {
+    if (sound && sound->loaded) {
+        ma_sound_set_looping(&sound->sound, loop);
+    }
+}
+
+// Nota: Deberíamos tener una función GE_CloseAudio() para llamar a ma_engine_uninit
+// Puedes agregarla dentro de GE_Close() si quieres ser estricto con la memoria.
+
+// ============================================================================
+// 7. SISTEMA DE TEXTO (CORREGIDO Y DEFINITIVO)
+// ============================================================================
+
+// Caché dinámica de glifos: cada carácter (texto en UTF-8) se rasteriza la primera vez
+// que aparece, con stbtt_MakeGlyphBitmap, en páginas de atlas A8 empaquetadas por
+// estantes (shelves). Las métricas (avance y caja) se guardan aparte y no se expulsan
+// nunca: medir texto no rasteriza nada. Si las páginas superan el presupuesto se
+// recicla la usada hace más tiempo y sus glifos se rasterizan otra vez si vuelven.
+//
+// El archivo TTF se mapea en memoria una sola vez por ruta (GE_FontFace) y todos los
+// tamaños lo comparten junto con su stbtt_fontinfo y las métricas sin escalar de cada
+// glifo; cada GE_Font solo guarda lo que depende del tamaño.
+
+#define GE_GLYPH_PAGE_SIZE 512   // Lado de una página (más si un glifo no cabe)
+#define GE_GLYPH_PADDING 1       // Separación entre glifos de una página
+#define GE_FONT_DEFAULT_BUDGET ((size_t)1024 * 1024) // 4 páginas A8 de 512x512
+#define GE_SDF_PADDING 8         // Texels de campo de distancias alrededor de cada glifo SDF
+
+// Mapa codepoint -> índice: ASCII con tabla directa, el resto de Unicode con hash abierto
+typedef struct {
+    int32_t ascii[128];      // -1 = sin entrada
+    uint32_t* keys;
+    int32_t* values;         // -1 = hueco
+    int size, count;         // size: potencia de 2 (0 = vacío)
+} GE_CodepointMap;
+
+static void GE_InitCodepointMap(GE_CodepointMap* map) {
+    memset(map, 0, sizeof(GE_CodepointMap));
+    for (int i = 0; i < 128; i++) map->ascii[i] = -1;
+}
+
+static void GE_FreeCodepointMap(GE_CodepointMap* map) {
+    free(map->keys);
+    free(map->values);
+    GE_InitCodepointMap(map);
+}
+
+static inline uint32_t GE_HashCodepoint(uint32_t cp) {
+    return cp * 2654435761u;
+}
+
+static inline int32_t GE_CodepointMapGet(const GE_CodepointMap* map, uint32_t cp) {
+    if (cp < 128) return map->ascii[cp];
+    if (map->size == 0) return -1;
+    uint32_t slot = GE_HashCodepoint(cp) & (map->size - 1);
+    while (map->values[slot] >= 0) {
+        if (map->keys[slot] == cp) return map->values[slot];
+        slot = (slot + 1) & (map->size - 1);
+    }
+    return -1;
+}
+
+// Inserta una clave nueva (quien llama ya comprobó que no existe). Crece al 50% de carga.
+static bool GE_CodepointMapPut(GE_CodepointMap* map, uint32_t cp, int32_t value) {
+    if (cp < 128) {
+        map->ascii[cp] = value;
+        return true;
+    }
+    if ((map->count + 1) * 2 > map->size) {
+        int size = map->size ? map->size * 2 : 256;
+        uint32_t* keys = (uint32_t*)malloc(size * sizeof(uint32_t));
+        int32_t* values = (int32_t*)malloc(size * sizeof(int32_t));
+        if (!keys || !values) {
+            free(keys);
+            free(values);
+            return false;
+        }
+        for (int i = 0; i < size; i++) values[i] = -1;
+        for (int i = 0; i < map->size; i++) {
+            if (map->values[i] < 0) continue;
+            uint32_t slot = GE_HashCodepoint(map->keys[i]) & (size - 1);
+            while (values[slot] >= 0) slot = (slot + 1) & (size - 1);
+            keys[slot] = map->keys[i];
+            values[slot] = map->values[i];
+        }
+        free(map->keys);
+        free(map->values);
+        map->keys = keys;
+        map->values = values;
+        map->size = size;
+    }
+    uint32_t slot = GE_HashCodepoint(cp) & (map->size - 1);
+    while (map->values[slot] >= 0) slot = (slot + 1) & (map->size - 1);
+    map->keys[slot] = cp;
+    map->values[slot] = value;
+    map->count++;
+    return true;
+}
+
+// Métricas de un glifo sin escalar (unidades de la fuente), comunes a todos los tamaños
+typedef struct {
+    uint32_t codepoint;
+    int glyph;               // Índice del glifo en el TTF (0 = no existe: .notdef)
+    int advance;
+    int x0, y0, x1, y1;      // Caja (todo 0 si no tiene contorno)
+} GE_FaceGlyph;
+
+enum { GE_KERN_NONE = 0, GE_KERN_TABLE, GE_KERN_GPOS };
+
+// Pares de kerning (hash abierto; clave 0 = hueco)
+typedef struct {
+    int mode;                // GE_KERN_*
+    uint32_t* keys;
+    int16_t* values;
+    int size, count;
+} GE_KernTable;
+
+struct GE_FontFace {
+    char* path;              // Clave del registro de caras abiertas
+    unsigned char* data;     // Archivo completo: mapeado (o leído si el mapeo falla)
+    size_t data_size;
+    bool mapped;
+    stbtt_fontinfo info;
+    int ascent, descent, line_gap; // Métricas verticales en unidades (descent es negativo)
+
+    GE_FaceGlyph* glyphs;
+    int glyph_count, glyph_capacity;
+    GE_CodepointMap map;
+
+    GE_KernTable kern;
+
+    int refs;                // Una por GE_LoadFontFace y una por cada GE_Font creado
+    struct GE_FontFace* next;
+};
+
+// Caras abiertas: cargar la misma ruta otra vez solo suma una referencia
+static GE_FontFace* g_font_faces = NULL;
+
+// Hilo de carga de fuentes (GE_LoadFontAsync). Se crea con el primer trabajo y termina
+// solo al vaciar la cola. Mientras existe, 'lock' protege la cola, el registro de caras,
+// sus referencias y la caché de glifos de cada cara (compartida entre tamaños).
+typedef struct {
+    ma_mutex lock;
+    ma_event done;           // Se señala al terminar cada trabajo
+    ma_thread thread;
+    struct GE_Font** queue;
+    int count, capacity;
+    bool initialized;        // lock/done creados (solo desde el hilo principal)
+    bool running, joinable;
+} GE_FontWorker;
+
+static GE_FontWorker g_font_worker;
+
+static inline void GE_LockFonts(void) {
+    if (g_font_worker.initialized) ma_mutex_lock(&g_font_worker.lock);
+}
+
+static inline void GE_UnlockFonts(void) {
+    if (g_font_worker.initialized) ma_mutex_unlock(&g_font_worker.lock);
+}
+
+typedef struct {
+    uint32_t codepoint;
+    int glyph;               // Índice del glifo en el TTF (en fuentes bitmap, el de GE_Font::glyphs)
+    float advance;           // Avance horizontal en píxeles
+    int16_t xoff, yoff;      // Esquina de la caja respecto al punto de la línea base
+    int16_t w, h;            // Tamaño del bitmap (0 = sin tinta, p. ej. el espacio)
+    int16_t x, y;            // Posición dentro de su página
+    int16_t page;            // -1 = sin rasterizar (o su página se recicló)
+} GE_Glyph;
+
+typedef struct { int y, height, x; } GE_GlyphShelf;
+
+typedef struct {
+    GE_Sprite* sprite;
+    GE_GlyphShelf* shelves;
+    int shelf_count, shelf_capacity;
+    int next_y;              // Primera fila libre debajo del último estante
+    uint32_t last_used;
+} GE_GlyphPage;
+
+#define GE_TEXT_RUN_SLOTS 64     // Textos maquetados cacheados por fuente
+#define GE_TEXT_RUN_BUCKETS 128  // Cubos del hash (potencia de 2)
+#define GE_TEXT_RUN_TTL 120      // Frames sin usarse antes de liberar una entrada
+
+typedef struct {
+    int32_t glyph;           // Índice en GE_Font::glyphs
+    float x;                 // Posición en la línea (suma de avances anteriores)
+} GE_RunGlyph;
+
+typedef struct {
+    int first, count;        // Tramo de GE_TextRun::glyphs
+    float width;             // Hasta el final de la última palabra (sin espacios finales)
+} GE_RunLine;
+
+typedef struct {
+    char* text;              // Copia de la cadena (NULL = hueco libre)
+    int length;
+    float wrap_width;        // Parte de la clave: ancho de ajuste (0 = solo saltos '\n')
+    uint32_t hash;
+    int32_t next;            // Siguiente en el mismo cubo (-1 = fin)
+    GE_RunGlyph* glyphs;     // Solo los glifos con tinta; 'x' relativo a su línea
+    int glyph_count, glyph_capacity;
+    GE_RunLine* lines;       // Siempre al menos una
+    int line_count, line_capacity;
+    float width;             // Línea más ancha
+    uint32_t last_frame;
+} GE_TextRun;
+
+enum { GE_FONT_READY = 0, GE_FONT_LOADING, GE_FONT_FAILED };
+
+// 1. Definición de la Estructura (Debe ir PRIMERO)
 struct GE_Font {
-    stbtt_bakedchar cdata[96]; // Información de caracteres ASCII 32..126
-    GE_Sprite* texture;        // El atlas de la fuente convertido a Sprite
-    float size;
+    GE_FontFace* face;       // Compartida con los demás tamaños (NULL = fuente bitmap)
+    float size;              // Tamaño base
+    float scale;             // Unidades de la fuente -> píxeles
+    float ascent, descent;   // Sobre / bajo la línea base en píxeles (descent <= 0)
+    float line_height;       // Distancia entre líneas base (incluye el interlineado)
+    bool sdf;                // Páginas con campo de distancias (GE_CreateFontSDF)
+
+    GE_Glyph* glyphs;
+    int glyph_count, glyph_capacity;
+    GE_CodepointMap map;
+
+    GE_GlyphPage* pages;
+    int page_count;
+    size_t budget, used;     // Bytes de páginas
+    uint32_t tick;           // Aumenta en cada dibujo (LRU de páginas)
+
+    GE_TextRun* runs;        // GE_TEXT_RUN_SLOTS entradas (se crean al primer uso)
+    int32_t run_buckets[GE_TEXT_RUN_BUCKETS];
+
+    GE_KernTable kern;       // Solo fuentes bitmap (face == NULL); las TTF usan el de su cara
+
+    // Carga en segundo plano: hasta estar lista, todo lo anterior es del hilo de fuentes
+    volatile ma_uint32 state; // GE_FONT_*
+    char* load_path;
+    struct GE_Font* fallback; // Se usa en su lugar mientras carga (o si falla)
 };
 
-GE_Font* GE_LoadFont(const char* filepath, float size) {
-    // 1. Leer el archivo .ttf completo a memoria
-    FILE* f = fopen(filepath, "rb");
-    if (!f) {
-        printf("[GE] Error: No se pudo abrir la fuente '%s'\n", filepath);
-        return NULL;
+// Siguiente codepoint de una cadena UTF-8. Secuencias inválidas -> U+FFFD (avanza 1 byte).
+static uint32_t GE_DecodeUTF8(const char** text) {
+    const unsigned char* s = (const unsigned char*)*text;
+    uint32_t cp;
+    int extra;
+    if (s[0] < 0x80)      { *text += 1; return s[0]; }
+    else if (s[0] < 0xC2) { *text += 1; return 0xFFFD; } // Continuación suelta o forma larga
+    else if (s[0] < 0xE0) { cp = s[0] & 0x1F; extra = 1; }
+    else if (s[0] < 0xF0) { cp = s[0] & 0x0F; extra = 2; }
+    else if (s[0] < 0xF5) { cp = s[0] & 0x07; extra = 3; }
+    else                  { *text += 1; return 0xFFFD; }
+
+    for (int i = 1; i <= extra; i++) {
+        if ((s[i] & 0xC0) != 0x80) { *text += 1; return 0xFFFD; } // También corta en el '\0'
+        cp = (cp << 6) | (s[i] & 0x3F);
+    }
+    static const uint32_t min_cp[4] = { 0, 0x80, 0x800, 0x10000 };
+    if (cp < min_cp[extra] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) { *text += 1; return 0xFFFD; }
+    *text += extra + 1;
+    return cp;
+}
+
+// Métricas sin escalar de 'cp' (se leen del TTF una vez por cara). NULL sin memoria.
+static const GE_FaceGlyph* GE_FindFaceGlyph(GE_FontFace* face, uint32_t cp) {
+    int32_t index = GE_CodepointMapGet(&face->map, cp);
+    if (index >= 0) return &face->glyphs[index];
+
+    if (face->glyph_count == face->glyph_capacity) {
+        int new_cap = face->glyph_capacity ? face->glyph_capacity * 2 : 128;
+        GE_FaceGlyph* list = (GE_FaceGlyph*)realloc(face->glyphs, new_cap * sizeof(GE_FaceGlyph));
+        if (!list) return NULL;
+        face->glyphs = list;
+        face->glyph_capacity = new_cap;
+    }
+    if (!GE_CodepointMapPut(&face->map, cp, face->glyph_count)) return NULL;
+
+    GE_FaceGlyph* fg = &face->glyphs[face->glyph_count++];
+    memset(fg, 0, sizeof(GE_FaceGlyph));
+    fg->codepoint = cp;
+    fg->glyph = stbtt_FindGlyphIndex(&face->info, (int)cp);
+    int lsb;
+    stbtt_GetGlyphHMetrics(&face->info, fg->glyph, &fg->advance, &lsb);
+    if (!stbtt_GetGlyphBox(&face->info, fg->glyph, &fg->x0, &fg->y0, &fg->x1, &fg->y1)) {
+        fg->x0 = fg->y0 = fg->x1 = fg->y1 = 0;
+    }
+    return fg;
+}
+
+// Índice del glifo de 'cp' en este tamaño (sin rasterizar). -1 sin memoria.
+static int GE_FindGlyph(GE_Font* font, uint32_t cp) {
+    int32_t index = GE_CodepointMapGet(&font->map, cp);
+    if (index >= 0) return index;
+    if (!font->face) return -1; // Fuente bitmap: solo los glifos del archivo
+
+    // La caché de la cara es compartida con tamaños que pueden estar cargándose en el hilo
+    GE_LockFonts();
+    const GE_FaceGlyph* found = GE_FindFaceGlyph(font->face, cp);
+    GE_FaceGlyph face_glyph;
+    if (found) face_glyph = *found;
+    GE_UnlockFonts();
+    if (!found) return -1;
+    const GE_FaceGlyph* fg = &face_glyph;
+    if (font->glyph_count == font->glyph_capacity) {
+        int new_cap = font->glyph_capacity ? font->glyph_capacity * 2 : 128;
+        GE_Glyph* list = (GE_Glyph*)realloc(font->glyphs, new_cap * sizeof(GE_Glyph));
+        if (!list) return -1;
+        font->glyphs = list;
+        font->glyph_capacity = new_cap;
+    }
+    if (!GE_CodepointMapPut(&font->map, cp, font->glyph_count)) return -1;
+
+    // Caja en píxeles con el mismo redondeo que stbtt_GetGlyphBitmapBox (y hacia abajo)
+    float scale = font->scale;
+    int x0 = (int)floorf(fg->x0 * scale), x1 = (int)ceilf(fg->x1 * scale);
+    int y0 = (int)floorf(-fg->y1 * scale), y1 = (int)ceilf(-fg->y0 * scale);
+    if (font->sdf && x0 != x1 && y0 != y1) { // Mismo margen que añade stbtt_GetGlyphSDF
+        x0 -= GE_SDF_PADDING; y0 -= GE_SDF_PADDING;
+        x1 += GE_SDF_PADDING; y1 += GE_SDF_PADDING;
+    }
+
+    index = font->glyph_count++;
+    GE_Glyph* g = &font->glyphs[index];
+    g->codepoint = cp;
+    g->glyph = fg->glyph;
+    g->advance = fg->advance * scale;
+    g->xoff = (int16_t)x0;
+    g->yoff = (int16_t)y0;
+    g->w = (int16_t)(x1 - x0);
+    g->h = (int16_t)(y1 - y0);
+    g->x = g->y = 0;
+    g->page = -1;
+    return index;
+}
+
+// --- KERNING ---
+// Tabla hash de pares de glifos (clave g1 << 16 | g2, valor en unidades), compartida por
+// todos los tamaños de la cara. Si la fuente solo trae tabla 'kern' se carga entera al
+// abrirla y un par ausente vale 0. Con GPOS (que stb no puede enumerar) se precalculan
+// los pares de ASCII imprimible y el resto se consulta una vez y queda memorizado.
+
+static inline uint32_t GE_KernKey(int g1, int g2) { // +1: la clave 0 queda para huecos
+    return ((uint32_t)(g1 + 1) << 16) | (uint32_t)((g2 + 1) & 0xFFFF);
+}
+
+// Inserta o actualiza un par. false sin memoria.
+static bool GE_PutKernPair(GE_KernTable* table, uint32_t key, int value) {
+    if ((table->count + 1) * 2 > table->size) {
+        int size = table->size ? table->size * 2 : 256;
+        uint32_t* keys = (uint32_t*)calloc(size, sizeof(uint32_t));
+        int16_t* values = (int16_t*)malloc(size * sizeof(int16_t));
+        if (!keys || !values) {
+            free(keys);
+            free(values);
+            return false;
+        }
+        for (int i = 0; i < table->size; i++) {
+            if (!table->keys[i]) continue;
+            uint32_t slot = GE_HashCodepoint(table->keys[i]) & (size - 1);
+            while (keys[slot]) slot = (slot + 1) & (size - 1);
+            keys[slot] = table->keys[i];
+            values[slot] = table->values[i];
+        }
+        free(table->keys);
+        free(table->values);
+        table->keys = keys;
+        table->values = values;
+        table->size = size;
+    }
+    uint32_t slot = GE_HashCodepoint(key) & (table->size - 1);
+    while (table->keys[slot] && table->keys[slot] != key) slot = (slot + 1) & (table->size - 1);
+    if (!table->keys[slot]) table->count++;
+    table->keys[slot] = key;
+    table->values[slot] = (int16_t)value;
+    return true;
+}
+
+static void GE_BuildKerning(GE_FontFace* face) {
+    const stbtt_fontinfo* info = &face->info;
+    GE_KernTable* table = &face->kern;
+    if (info->gpos) {
+        int glyphs[95];
+        for (int i = 0; i < 95; i++) glyphs[i] = stbtt_FindGlyphIndex(info, 32 + i);
+        for (int a = 0; a < 95; a++) {
+            for (int b = 0; b < 95; b++) {
+                int k = stbtt_GetGlyphKernAdvance(info, glyphs[a], glyphs[b]);
+                if (k && !GE_PutKernPair(table, GE_KernKey(glyphs[a], glyphs[b]), k)) return;
+            }
+        }
+        table->mode = GE_KERN_GPOS;
+    } else if (info->kern) {
+        int count = stbtt_GetKerningTableLength(info);
+        stbtt_kerningentry* entries = count > 0 ? (stbtt_kerningentry*)malloc(count * sizeof(stbtt_kerningentry)) : NULL;
+        if (!entries) return;
+        count = stbtt_GetKerningTable(info, entries, count);
+        for (int i = 0; i < count; i++) {
+            if (entries[i].advance && !GE_PutKernPair(table, GE_KernKey(entries[i].glyph1, entries[i].glyph2), entries[i].advance)) break;
+        }
+        free(entries);
+        table->mode = GE_KERN_TABLE;
+    }
+}
+
+static void GE_FreeKernTable(GE_KernTable* table) {
+    free(table->keys);
+    free(table->values);
+    memset(table, 0, sizeof(*table));
+}
+
+// Ajuste entre dos glifos seguidos, en unidades de la fuente
+static int GE_GetKerning(GE_Font* font, const GE_Glyph* a, const GE_Glyph* b) {
+    GE_KernTable* table = font->face ? &font->face->kern : &font->kern;
+    if (table->mode == GE_KERN_NONE) return 0;
+    uint32_t key = GE_KernKey(a->glyph, b->glyph);
+    if (table->size) {
+        uint32_t slot = GE_HashCodepoint(key) & (table->size - 1);
+        while (table->keys[slot]) {
+            if (table->keys[slot] == key) return table->values[slot];
+            slot = (slot + 1) & (table->size - 1);
+        }
+    }
+    if (table->mode == GE_KERN_TABLE || (a->codepoint < 127 && b->codepoint < 127)) return 0;
+
+    // GPOS fuera de ASCII: se consulta una vez (también los ceros)
+    int k = stbtt_GetGlyphKernAdvance(&font->face->info, a->glyph, b->glyph);
+    GE_PutKernPair(table, key, k);
+    return k;
+}
+
+// Hueco de w x h en la página: el estante más bajo donde quepa o uno nuevo debajo
+static bool GE_PlaceGlyph(GE_GlyphPage* page, int w, int h, int* out_x, int* out_y) {
+    int best = -1;
+    for (int i = 0; i < page->shelf_count; i++) {
+        GE_GlyphShelf* shelf = &page->shelves[i];
+        if (shelf->height < h || shelf->x + w > page->sprite->width) continue;
+        if (best < 0 || shelf->height < page->shelves[best].height) best = i;
+    }
+    if (best < 0) {
+        if (page->next_y + h > page->sprite->height || w > page->sprite->width) return false;
+        if (page->shelf_count == page->shelf_capacity) {
+            int new_cap = page->shelf_capacity ? page->shelf_capacity * 2 : 16;
+            GE_GlyphShelf* list = (GE_GlyphShelf*)realloc(page->shelves, new_cap * sizeof(GE_GlyphShelf));
+            if (!list) return false;
+            page->shelves = list;
+            page->shelf_capacity = new_cap;
+        }
+        best = page->shelf_count++;
+        page->shelves[best] = (GE_GlyphShelf){ page->next_y, h, 0 };
+        page->next_y += h;
+    }
+    *out_x = page->shelves[best].x;
+    *out_y = page->shelves[best].y;
+    page->shelves[best].x += w;
+    return true;
+}
+
+// Página vacía para un glifo de w x h: nueva si cabe en el presupuesto; si no, se recicla
+// la usada hace más tiempo (nunca una usada en el dibujo en curso). -1 si no hay memoria.
+static int GE_AcquireGlyphPage(GE_Context* ctx, GE_Font* font, int w, int h) {
+    int side = GE_GLYPH_PAGE_SIZE;
+    while (side < w || side < h) side *= 2;
+    size_t bytes = (size_t)side * side; // A8: un byte por texel
+
+    // Mientras se graba una pasada diferida sus comandos apuntan a estas páginas
+    bool can_evict = !(ctx && ctx->deferred && ctx->deferred->recording);
+    while (can_evict && font->used + bytes > font->budget) {
+        int lru = -1;
+        for (int i = 0; i < font->page_count; i++) {
+            GE_GlyphPage* p = &font->pages[i];
+            if (!p->sprite || p->last_used == font->tick) continue;
+            if (lru < 0 || p->last_used < font->pages[lru].last_used) lru = i;
+        }
+        if (lru < 0) break;
+
+        // El render multihilo puede tener dibujos pendientes que leen la página
+        if (ctx) GE_FlushRendering(ctx);
+        for (int i = 0; i < font->glyph_count; i++) {
+            if (font->glyphs[i].page == lru) font->glyphs[i].page = -1;
+        }
+        GE_GlyphPage* p = &font->pages[lru];
+        p->shelf_count = 0;
+        p->next_y = 0;
+        if (p->sprite->width == side) {
+            memset(p->sprite->data, 0, bytes);
+            return lru;
+        }
+        font->used -= (size_t)p->sprite->width * p->sprite->height;
+        GE_UnloadSprite(p->sprite);
+        p->sprite = NULL;
+    }
+
+    int index = -1;
+    for (int i = 0; i < font->page_count && index < 0; i++) {
+        if (!font->pages[i].sprite) index = i;
+    }
+    if (index < 0) {
+        GE_GlyphPage* pages = (GE_GlyphPage*)realloc(font->pages, (font->page_count + 1) * sizeof(GE_GlyphPage));
+        if (!pages) return -1;
+        font->pages = pages;
+        index = font->page_count++;
+        memset(&font->pages[index], 0, sizeof(GE_GlyphPage));
+    }
+
+    unsigned char* data = (unsigned char*)calloc(bytes, 1);
+    GE_Sprite* sprite = data ? (GE_Sprite*)calloc(1, sizeof(GE_Sprite)) : NULL;
+    if (!sprite) {
+        free(data);
+        return -1;
+    }
+    GE_InitSpriteCoverage(sprite, side, side, data);
+    font->pages[index].sprite = sprite;
+    font->pages[index].shelf_count = 0;
+    font->pages[index].next_y = 0;
+    font->used += bytes;
+    return index;
+}
+
+// Rasteriza el glifo directamente en su hueco de la página (cobertura A8 o campo de distancias)
+static bool GE_RasterizeGlyph(GE_Context* ctx, GE_Font* font, GE_Glyph* g) {
+    if (!font->face) return false;
+    int w = g->w + GE_GLYPH_PADDING, h = g->h + GE_GLYPH_PADDING;
+    int page = -1, x = 0, y = 0;
+    for (int i = font->page_count - 1; i >= 0 && page < 0; i--) {
+        if (font->pages[i].sprite && GE_PlaceGlyph(&font->pages[i], w, h, &x, &y)) page = i;
+    }
+    if (page < 0) {
+        page = GE_AcquireGlyphPage(ctx, font, w, h);
+        if (page < 0 || !GE_PlaceGlyph(&font->pages[page], w, h, &x, &y)) return false;
+    }
+
+    GE_Sprite* sprite = font->pages[page].sprite;
+    unsigned char* dst = sprite->data + (size_t)y * sprite->pitch + x;
+    if (font->sdf) {
+        int sw, sh, sx, sy;
+        unsigned char* field = stbtt_GetGlyphSDF(&font->face->info, font->scale, g->glyph, GE_SDF_PADDING, 128,
+                                                 128.0f / GE_SDF_PADDING, &sw, &sh, &sx, &sy);
+        if (!field) return false;
+        if (sw != g->w || sh != g->h) { // La caja del glifo tiene que cubrir el campo entero
+            printf("[GE] Error: Campo SDF de %dx%d para una caja de %dx%d (U+%04X)\n", sw, sh, g->w, g->h, g->codepoint);
+            stbtt_FreeSDF(field, NULL);
+            return false;
+        }
+        for (int row = 0; row < sh; row++) memcpy(dst + row * sprite->pitch, field + row * sw, sw);
+        stbtt_FreeSDF(field, NULL);
+    } else {
+        stbtt_MakeGlyphBitmap(&font->face->info, dst, g->w, g->h, sprite->pitch, font->scale, font->scale, g->glyph);
+    }
+
+    g->x = (int16_t)x;
+    g->y = (int16_t)y;
+    g->page = (int16_t)page;
+    return true;
+}
+
+// Archivo completo en memoria de solo lectura: mapeado si se puede, si no leído
+static unsigned char* GE_MapFile(const char* filepath, size_t* out_size, bool* out_mapped) {
+    *out_mapped = false;
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER size;
+        HANDLE mapping = NULL;
+        void* view = NULL;
+        if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+            mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (mapping) view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        }
+        if (mapping) CloseHandle(mapping); // La vista sigue siendo válida
+        CloseHandle(file);
+        if (view) {
+            *out_size = (size_t)size.QuadPart;
+            *out_mapped = true;
+            return (unsigned char*)view;
+        }
+    }
+#else
+    int fd = open(filepath, O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        void* view = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd); // El mapeo sigue siendo válido
+        if (view != MAP_FAILED) {
+            *out_size = (size_t)st.st_size;
+            *out_mapped = true;
+            return (unsigned char*)view;
+        }
     }
+#endif
+
+    FILE* f = fopen(filepath, "rb");
+    if (!f) return NULL;
     fseek(f, 0, SEEK_END);
     long fsize = ftell(f);
     fseek(f, 0, SEEK_SET);
-
-    unsigned char* ttf_buffer = (unsigned char*)malloc(fsize);
-    fread(ttf_buffer, 1, fsize, f);
+    unsigned char* data = (unsigned char*)malloc(fsize > 0 ? fsize : 1);
+    if (!data || fsize <= 0 || fread(data, 1, fsize, f) != (size_t)fsize) {
+        free(data);
+        fclose(f);
+        return NULL;
+    }
     fclose(f);
+    *out_size = (size_t)fsize;
+    return data;
+}
 
-    // 2. Crear un bitmap temporal para el "Atlas" de la fuente
-    int width = 512;
-    int height = 512;
-    unsigned char* temp_bitmap = (unsigned char*)malloc(width * height);
+static void GE_UnmapFile(unsigned char* data, size_t size, bool mapped) {
+    if (!data) return;
+    if (!mapped) {
+        free(data);
+        return;
+    }
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(data);
+#else
+    munmap(data, size);
+#endif
+}
 
-    GE_Font* font = (GE_Font*)calloc(1, sizeof(GE_Font));
-    font->size = size;
+static void GE_FreeFontFace(GE_FontFace* face) {
+    GE_FreeCodepointMap(&face->map);
+    free(face->glyphs);
+    GE_FreeKernTable(&face->kern);
+    GE_UnmapFile(face->data, face->data_size, face->mapped);
+    free(face->path);
+    free(face);
+}
 
-    // 3. "Hornear" (Bake) los caracteres al bitmap
-    // Esto dibuja todas las letras en una sola imagen en blanco y negro
-    stbtt_BakeFontBitmap(ttf_buffer, 0, size, temp_bitmap, width, height, 32, 96, font->cdata);
-    
-    free(ttf_buffer); // Ya no necesitamos el archivo original
+// Cara ya abierta con esa ruta (con una referencia más) o NULL. Llamar con el bloqueo.
+static GE_FontFace* GE_AcquireOpenFace(const char* filepath) {
+    for (GE_FontFace* face = g_font_faces; face; face = face->next) {
+        if (strcmp(face->path, filepath) == 0) {
+            face->refs++;
+            return face;
+        }
+    }
+    return NULL;
+}
 
-    // 4. Convertir el bitmap de 1 canal (Gris) a nuestro formato de Sprite (RGBA)
-    font->texture = (GE_Sprite*)malloc(sizeof(GE_Sprite));
-    font->texture->width = width;
-    font->texture->height = height;
-    font->texture->channels = 4;
-    font->texture->data = (unsigned char*)malloc(width * height * 4);
+GE_FontFace* GE_LoadFontFace(const char* filepath) {
+    if (!filepath) return NULL;
+    GE_LockFonts();
+    GE_FontFace* open = GE_AcquireOpenFace(filepath);
+    GE_UnlockFonts();
+    if (open) return open;
+
+    size_t size = 0;
+    bool mapped = false;
+    unsigned char* data = GE_MapFile(filepath, &size, &mapped);
+    if (!data) {
+        printf("[GE] ERROR CRITICO: No se encontro la fuente '%s'.\n", filepath);
+        return NULL;
+    }
 
-    for (int i = 0; i < width * height; i++) {
-        uint8_t value = temp_bitmap[i];
-        // Lo convertimos a blanco puro, usando el valor como Alpha
-        font->texture->data[i*4 + 0] = 255; // R
-        font->texture->data[i*4 + 1] = 255; // G
-        font->texture->data[i*4 + 2] = 255; // B
-        font->texture->data[i*4 + 3] = value; // Alpha
+    GE_FontFace* face = (GE_FontFace*)calloc(1, sizeof(GE_FontFace));
+    char* path = (char*)malloc(strlen(filepath) + 1);
+    if (!face || !path) {
+        free(face);
+        free(path);
+        GE_UnmapFile(data, size, mapped);
+        return NULL;
+    }
+    int offset = stbtt_GetFontOffsetForIndex(data, 0);
+    if (offset < 0 || !stbtt_InitFont(&face->info, data, offset)) {
+        printf("[GE] Error: '%s' no es una fuente TrueType valida\n", filepath);
+        free(face);
+        free(path);
+        GE_UnmapFile(data, size, mapped);
+        return NULL;
     }
+    strcpy(path, filepath);
+    stbtt_GetFontVMetrics(&face->info, &face->ascent, &face->descent, &face->line_gap);
+    GE_BuildKerning(face);
+    face->path = path;
+    face->data = data;
+    face->data_size = size;
+    face->mapped = mapped;
+    GE_InitCodepointMap(&face->map);
+    face->refs = 1;
+
+    // El otro hilo pudo abrir la misma ruta mientras tanto: se queda la primera
+    GE_LockFonts();
+    open = GE_AcquireOpenFace(filepath);
+    if (!open) {
+        face->next = g_font_faces;
+        g_font_faces = face;
+    }
+    GE_UnlockFonts();
+    if (open) {
+        GE_FreeFontFace(face);
+        return open;
+    }
+    return face;
+}
 
-    free(temp_bitmap);
+void GE_UnloadFontFace(GE_FontFace* face) {
+    if (!face) return;
+    GE_LockFonts();
+    bool last = --face->refs == 0;
+    if (last) {
+        for (GE_FontFace** link = &g_font_faces; *link; link = &(*link)->next) {
+            if (*link == face) {
+                *link = face->next;
+                break;
+            }
+        }
+    }
+    GE_UnlockFonts();
+    if (last) GE_FreeFontFace(face);
+}
+
+// Métricas y tabla de ASCII de un tamaño (la fuente toma su propia referencia de la cara)
+static void GE_SetupFont(GE_Font* font, GE_FontFace* face, float size) {
+    GE_LockFonts();
+    face->refs++;
+    GE_UnlockFonts();
+    font->face = face;
+    font->size = size;
+    font->scale = stbtt_ScaleForPixelHeight(&face->info, size);
+    font->ascent = face->ascent * font->scale;
+    font->descent = face->descent * font->scale;
+    font->line_height = (face->ascent - face->descent + face->line_gap) * font->scale;
+    if (!font->budget) font->budget = GE_FONT_DEFAULT_BUDGET; // Respeta uno fijado antes de cargar
+    GE_InitCodepointMap(&font->map);
+    // Tabla plana de ASCII imprimible lista desde el principio (avances y cajas)
+    for (uint32_t cp = 32; cp < 127; cp++) GE_FindGlyph(font, cp);
+}
+
+// 2. Función de Carga
+GE_Font* GE_CreateFont(GE_FontFace* face, float size) {
+    if (!face || size <= 0) return NULL;
+    GE_Font* font = (GE_Font*)calloc(1, sizeof(GE_Font));
+    if (!font) return NULL;
+    GE_SetupFont(font, face, size);
     return font;
 }
 
-void GE_UnloadFont(GE_Font* font) {
-    if (font) {
-        if (font->texture) GE_UnloadSprite(font->texture);
-        free(font);
+GE_Font* GE_CreateFontSDF(GE_FontFace* face, float base_size) {
+    if (!face || base_size <= 0) return NULL;
+    GE_Font* font = (GE_Font*)calloc(1, sizeof(GE_Font));
+    if (!font) return NULL;
+    font->sdf = true; // Antes de la tabla de ASCII: las cajas llevan el margen del campo
+    GE_SetupFont(font, face, base_size);
+    return font;
+}
+
+GE_Font* GE_LoadFont(const char* filepath, float size) {
+    GE_FontFace* face = GE_LoadFontFace(filepath);
+    if (!face) return NULL;
+    GE_Font* font = GE_CreateFont(face, size);
+    GE_UnloadFontFace(face); // La fuente conserva su propia referencia
+    return font;
+}
+
+// --- CARGA EN SEGUNDO PLANO ---
+// GE_LoadFontAsync devuelve la fuente al momento y el hilo de fuentes hace el trabajo
+// caro: abrir y analizar la cara, la tabla de kerning y rasterizar el ASCII imprimible
+// en el atlas. Hasta que termina, medir y dibujar usan la fuente de respaldo (o no
+// hacen nada); GE_IsFontReady dice cuándo está lista. Los glifos fuera de ASCII se
+// siguen rasterizando al primer uso en el hilo principal.
+
+static void GE_BakeFont(GE_Font* font) {
+    GE_FontFace* face = GE_LoadFontFace(font->load_path);
+    if (face) {
+        GE_SetupFont(font, face, font->size);
+        GE_UnloadFontFace(face); // La fuente conserva su propia referencia
+        for (int i = 0; i < font->glyph_count; i++) {
+            GE_Glyph* g = &font->glyphs[i];
+            if (g->w > 0 && g->h > 0 && g->page < 0) GE_RasterizeGlyph(NULL, font, g);
+        }
     }
+    ma_atomic_store_32(&font->state, face ? GE_FONT_READY : GE_FONT_FAILED);
 }
 
-void GE_DrawText(GE_Context* ctx, GE_Font* font, const char* text, float x, float y, GE_Color color) {
-    if (!font || !text) return;
+static ma_thread_result MA_THREADCALL GE_FontWorkerMain(void* data) {
+    (void)data;
+    GE_FontWorker* w = &g_font_worker;
+    for (;;) {
+        ma_mutex_lock(&w->lock);
+        if (w->count == 0) {
+            w->running = false;
+            ma_mutex_unlock(&w->lock);
+            break;
+        }
+        GE_Font* font = w->queue[0];
+        memmove(w->queue, w->queue + 1, (w->count - 1) * sizeof(GE_Font*));
+        w->count--;
+        ma_mutex_unlock(&w->lock);
 
-    // Extraer componentes del color para tintar
-    // (Aprovechamos que GE_DrawSpriteEx ya soporta tintes)
-    
-    float startX = x;
+        GE_BakeFont(font);
+        ma_event_signal(&w->done);
+    }
+    return (ma_thread_result)0;
+}
 
-    while (*text) {
-        if (*text >= 32 && *text < 128) {
-            stbtt_aligned_quad q;
-            // Obtener coordenadas del caracter dentro del atlas
-            stbtt_GetBakedQuad(font->cdata, 512, 512, *text - 32, &x, &y, &q, 1);
-            
-            // Convertir coordenadas de Quad a Rect
-            GE_Rect src = { q.s0 * 512, q.t0 * 512, (q.s1 - q.s0) * 512, (q.t1 - q.t0) * 512 };
-            GE_Rect dst = { q.x0, q.y0, q.x1 - q.x0, q.y1 - q.y0 };
+// Encola la fuente y arranca el hilo si no está en marcha. false si no se pudo.
+static bool GE_QueueFontLoad(GE_Font* font) {
+    GE_FontWorker* w = &g_font_worker;
+    if (!w->initialized) {
+        if (ma_mutex_init(&w->lock) != MA_SUCCESS) return false;
+        if (ma_event_init(&w->done) != MA_SUCCESS) {
+            ma_mutex_uninit(&w->lock);
+            return false;
+        }
+        w->initialized = true;
+    }
 
-            // Dibujar la letra usando nuestro sistema de Sprites existente
-            GE_DrawSpriteEx(ctx, font->texture, src, dst, color);
+    ma_mutex_lock(&w->lock);
+    bool queued = true;
+    if (w->count == w->capacity) {
+        int new_cap = w->capacity ? w->capacity * 2 : 8;
+        GE_Font** list = (GE_Font**)realloc(w->queue, new_cap * sizeof(GE_Font*));
+        if (list) {
+            w->queue = list;
+            w->capacity = new_cap;
+        } else {
+            queued = false;
         }
-        text++;
     }
+    if (queued) w->queue[w->count++] = font;
+    bool start = queued && !w->running;
+    if (start) w->running = true;
+    ma_mutex_unlock(&w->lock);
+    if (!start) return queued;
+
+    // El hilo anterior ya salió de su bucle (running = false): solo queda recogerlo
+    if (w->joinable) ma_thread_wait(&w->thread);
+    w->joinable = ma_thread_create(&w->thread, ma_thread_priority_normal, 0, GE_FontWorkerMain, NULL, NULL) == MA_SUCCESS;
+    if (w->joinable) return true;
+
+    ma_mutex_lock(&w->lock);
+    w->count--; // Sin hilo nadie más ha tocado la cola
+    w->running = false;
+    ma_mutex_unlock(&w->lock);
+    return false;
 }
 
+// Espera a que el hilo termine (bien o mal) con una fuente asíncrona
+static void GE_AwaitFontLoad(GE_Font* font) {
+    GE_FontWorker* w = &g_font_worker;
+    if (!w->initialized) return;
+    while (ma_atomic_load_32(&font->state) == GE_FONT_LOADING) ma_event_wait(&w->done);
+}
 
-GE_Point GE_MeasureText(GE_Font* font, const char* text) {
-    if (!font || !text) return (GE_Point){0,0};
-    
-    float x = 0;
-    float y = 0;
-    
-    // Recorremos el texto char a char
-    const char* ptr = text;
-    while (*ptr) {
-        if (*ptr >= 32 && *ptr < 128) {
-            stbtt_aligned_quad q;
-            // GetBakedQuad avanza la variable 'x' automáticamente
-            stbtt_GetBakedQuad(font->cdata, 512, 512, *ptr - 32, &x, &y, &q, 1);
+// Antes de liberar una fuente asíncrona: se quita de la cola o se espera a que el hilo acabe con ella
+static void GE_WaitFontLoad(GE_Font* font) {
+    GE_FontWorker* w = &g_font_worker;
+    if (!w->initialized || ma_atomic_load_32(&font->state) != GE_FONT_LOADING) return;
+    ma_mutex_lock(&w->lock);
+    for (int i = 0; i < w->count; i++) {
+        if (w->queue[i] == font) {
+            memmove(w->queue + i, w->queue + i + 1, (w->count - i - 1) * sizeof(GE_Font*));
+            w->count--;
+            ma_atomic_store_32(&font->state, GE_FONT_FAILED);
+            break;
         }
-        ptr++;
     }
-    
-    // x ahora contiene el ancho total del texto
-    // Asumimos una altura estándar basada en el tamaño de fuente (aprox)
-    return (GE_Point){ x, 32.0f }; 
+    ma_mutex_unlock(&w->lock);
+    GE_AwaitFontLoad(font);
 }
 
-// Stub para alineación (puedes implementarlo calculando MeasureText primero)
-void GE_DrawTextAligned(GE_Context* c, GE_Font* f, const char* t, float x, float y, GE_TextAlign align, GE_Color col) {
-    if (!c || !f || !t) return;
+// Cierre (GE_Close): las fuentes aún en cola quedan como fallidas, se espera a la que se
+// está cargando y se liberan el hilo, el bloqueo y el evento. Un GE_LoadFontAsync
+// posterior vuelve a crearlos.
+static void GE_ShutdownFontWorker(void) {
+    GE_FontWorker* w = &g_font_worker;
+    if (!w->initialized) return;
+    ma_mutex_lock(&w->lock);
+    for (int i = 0; i < w->count; i++) ma_atomic_store_32(&w->queue[i]->state, GE_FONT_FAILED);
+    w->count = 0;
+    ma_mutex_unlock(&w->lock);
+
+    if (w->joinable) ma_thread_wait(&w->thread);
+    ma_event_uninit(&w->done);
+    ma_mutex_uninit(&w->lock);
+    free(w->queue);
+    memset(w, 0, sizeof(*w));
+}
 
-    // 1. Si es alineación izquierda, dibujamos normal y salimos (ahorra cálculos)
-    if (align == GE_ALIGN_LEFT) {
-        GE_DrawText(c, f, t, x, y, col);
-        return;
+GE_Font* GE_LoadFontAsync(const char* filepath, float size, GE_Font* fallback) {
+    if (!filepath || size <= 0) return NULL;
+    GE_Font* font = (GE_Font*)calloc(1, sizeof(GE_Font));
+    char* path = (char*)malloc(strlen(filepath) + 1);
+    if (!font || !path) {
+        free(font);
+        free(path);
+        return NULL;
+    }
+    strcpy(path, filepath);
+    font->load_path = path;
+    font->size = size;
+    font->fallback = fallback;
+    font->budget = GE_FONT_DEFAULT_BUDGET;
+    font->state = GE_FONT_LOADING;
+    if (!GE_QueueFontLoad(font)) {
+        // Sin hilo: se carga aquí mismo
+        printf("[GE] Error: No se pudo iniciar la carga en segundo plano de '%s'\n", filepath);
+        GE_BakeFont(font);
     }
+    return font;
+}
 
-    // 2. Medimos el ancho del texto
-    GE_Point size = GE_MeasureText(f, t);
-    
-    // 3. Ajustamos la posición X según la alineación
-    float finalX = x;
-    
-    if (align == GE_ALIGN_CENTER) {
-        finalX = x - (size.x / 2.0f); // Restamos la mitad del ancho
-    } 
-    else if (align == GE_ALIGN_RIGHT) {
-        finalX = x - size.x;          // Restamos todo el ancho
+bool GE_IsFontReady(GE_Font* font) {
+    return font && ma_atomic_load_32(&font->state) == GE_FONT_READY;
+}
+
+// Fuente con la que se mide y dibuja: la propia si está lista; si no, su respaldo (o ninguna)
+static GE_Font* GE_ReadyFont(GE_Font* font) {
+    if (!font || GE_IsFontReady(font)) return font;
+    return GE_IsFontReady(font->fallback) ? font->fallback : NULL;
+}
+
+void GE_UnloadFont(GE_Font* font) {
+    if (font) {
+        GE_WaitFontLoad(font);
+        for (int i = 0; i < font->page_count; i++) {
+            if (font->pages[i].sprite) GE_UnloadSprite(font->pages[i].sprite);
+            free(font->pages[i].shelves);
+        }
+        free(font->pages);
+        if (font->runs) {
+            for (int i = 0; i < GE_TEXT_RUN_SLOTS; i++) {
+                free(font->runs[i].text);
+                free(font->runs[i].glyphs);
+                free(font->runs[i].lines);
+            }
+            free(font->runs);
+        }
+        free(font->glyphs);
+        GE_FreeCodepointMap(&font->map);
+        GE_FreeKernTable(&font->kern);
+        GE_UnloadFontFace(font->face);
+        free(font->load_path);
+        free(font);
     }
-    
-    // 4. Dibujamos en la nueva posición calculada
-    GE_DrawText(c, f, t, finalX, y, col);
 }
 
-*/
+// Las páginas de una fuente en carga son del hilo de fuentes: se espera a que termine
+void GE_SetFontCacheBudget(GE_Font* font, size_t budget_bytes) {
+    if (!font) return;
+    GE_AwaitFontLoad(font);
+    font->budget = budget_bytes;
+}
 
+// --- FUENTES BITMAP (BMFont) ---
+// Fuentes ya rasterizadas de AngelCode BMFont: un descriptor .fnt (texto, XML o binario)
+// más las imágenes de sus páginas. Glifos, páginas y kerning se vuelcan tal cual a las
+// mismas estructuras que las fuentes TTF, así que se miden y dibujan con las mismas
+// funciones sin rasterizar nada. Las páginas en escala de grises (blanco con alpha o
+// blanco sobre negro) pasan a cobertura A8 y se tiñen como el resto del texto; las de
+// color se conservan RGBA y el color del texto las multiplica (blanco = colores originales).
+
+typedef struct {
+    uint32_t first, second;
+    int amount;
+} GE_BMKerning;
+
+typedef struct {
+    GE_Font* font;
+    int size, base, line_height;
+    char** pages;            // Nombres de archivo, relativos al .fnt
+    int page_count;
+    GE_BMKerning* kernings;
+    int kerning_count, kerning_capacity;
+    bool packed;             // Glifos repartidos por canales (no soportado)
+} GE_BMFontLoad;
+
+static bool GE_BMFontAddChar(GE_BMFontLoad* ld, uint32_t id, int x, int y, int w, int h,
+                             int xoff, int yoff, int xadvance, int page, int chnl) {
+    GE_Font* font = ld->font;
+    if (chnl != 0 && chnl != 15) ld->packed = true;
+    if (GE_CodepointMapGet(&font->map, id) >= 0) return true; // Repetido: vale el primero
+    if (font->glyph_count == font->glyph_capacity) {
+        int new_cap = font->glyph_capacity ? font->glyph_capacity * 2 : 128;
+        GE_Glyph* list = (GE_Glyph*)realloc(font->glyphs, new_cap * sizeof(GE_Glyph));
+        if (!list) return false;
+        font->glyphs = list;
+        font->glyph_capacity = new_cap;
+    }
+    if (!GE_CodepointMapPut(&font->map, id, font->glyph_count)) return false;
+
+    int index = font->glyph_count++;
+    GE_Glyph* g = &font->glyphs[index];
+    g->codepoint = id;
+    g->glyph = index;
+    g->advance = (float)xadvance;
+    g->xoff = (int16_t)xoff;
+    g->yoff = (int16_t)yoff; // Desde el borde superior de la línea; se pasa a la base al final
+    g->w = (int16_t)w;
+    g->h = (int16_t)h;
+    g->x = (int16_t)x;
+    g->y = (int16_t)y;
+    g->page = (int16_t)page;
+    return true;
+}
 
-// ============================================================================
-// 8. IMPLEMENTACIÓN DE AUDIO (MINIAUDIO)
-// ============================================================================
+static bool GE_BMFontSetPage(GE_BMFontLoad* ld, int id, const char* name, size_t length) {
+    if (id < 0 || id > 255) return true;
+    if (id >= ld->page_count) {
+        char** pages = (char**)realloc(ld->pages, (id + 1) * sizeof(char*));
+        if (!pages) return false;
+        for (int i = ld->page_count; i <= id; i++) pages[i] = NULL;
+        ld->pages = pages;
+        ld->page_count = id + 1;
+    }
+    char* copy = (char*)malloc(length + 1);
+    if (!copy) return false;
+    memcpy(copy, name, length);
+    copy[length] = '\0';
+    free(ld->pages[id]);
+    ld->pages[id] = copy;
+    return true;
+}
 
-// Estructura interna para manejar el motor de audio global
-// Usamos una variable global estática para el motor porque miniaudio lo requiere
-static ma_engine g_audioEngine;
-static bool g_audioInitialized = false;
+static bool GE_BMFontAddKerning(GE_BMFontLoad* ld, uint32_t first, uint32_t second, int amount) {
+    if (!amount) return true;
+    if (ld->kerning_count == ld->kerning_capacity) {
+        int new_cap = ld->kerning_capacity ? ld->kerning_capacity * 2 : 64;
+        GE_BMKerning* list = (GE_BMKerning*)realloc(ld->kernings, new_cap * sizeof(GE_BMKerning));
+        if (!list) return false;
+        ld->kernings = list;
+        ld->kerning_capacity = new_cap;
+    }
+    ld->kernings[ld->kerning_count++] = (GE_BMKerning){ first, second, amount };
+    return true;
+}
 
-// Función interna para iniciar el motor si no está iniciado
-static void GE_InitAudioSystem() {
-    if (!g_audioInitialized) {
-        if (ma_engine_init(NULL, &g_audioEngine) == MA_SUCCESS) {
-            g_audioInitialized = true;
-            printf("[GE] Sistema de Audio Inicializado.\n");
+// Atributos 'clave=valor' de una línea del formato de texto o XML (valores con o sin comillas)
+typedef struct {
+    const char* key;
+    const char* value;
+} GE_BMAttr;
+
+static int GE_ParseBMFontLine(char* line, const char** tag, GE_BMAttr* attrs, int max_attrs) {
+    char* p = line;
+    while (*p == ' ' || *p == '\t' || *p == '<') p++;
+    *tag = p;
+    while (*p && *p != ' ' && *p != '\t' && *p != '/' && *p != '>') p++;
+    if (*p) *p++ = '\0';
+
+    int count = 0;
+    while (count < max_attrs) {
+        while (*p == ' ' || *p == '\t') p++;
+        if (!*p || *p == '/' || *p == '>') break;
+        char* key = p;
+        while (*p && *p != '=' && *p != ' ' && *p != '\t') p++;
+        if (*p != '=') { // Atributo sin valor: se ignora
+            if (*p) *p++ = '\0';
+            continue;
+        }
+        *p++ = '\0';
+        char* value = p;
+        if (*p == '"') {
+            value = ++p;
+            while (*p && *p != '"') p++;
         } else {
-            printf("[GE] Error: Fallo al iniciar Audio.\n");
+            while (*p && *p != ' ' && *p != '\t' && *p != '/' && *p != '>') p++;
         }
+        if (*p) *p++ = '\0';
+        attrs[count].key = key;
+        attrs[count].value = value;
+        count++;
     }
+    return count;
 }
 
-struct GE_Sound {
-    ma_sound sound; // Objeto de sonido de miniaudio
-    bool loaded;
-};
+static const char* GE_BMAttrStr(const GE_BMAttr* attrs, int count, const char* key) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(attrs[i].key, key) == 0) return attrs[i].value;
+    }
+    return NULL;
+}
 
-GE_Sound* GE_LoadSound(const char* filepath) {
-    GE_InitAudioSystem(); // Asegurar que el sistema existe
-    if (!g_audioInitialized) return NULL;
+static int GE_BMAttrInt(const GE_BMAttr* attrs, int count, const char* key) {
+    const char* value = GE_BMAttrStr(attrs, count, key);
+    return value ? (int)strtol(value, NULL, 10) : 0;
+}
 
-    GE_Sound* s = (GE_Sound*)malloc(sizeof(GE_Sound));
-    
-    // Cargar sonido decodificándolo directamente (Stream es mejor para música, Decode para SFX)
-    // Aquí usamos MA_SOUND_FLAG_DECODE para cargarlo en RAM (mejor para efectos cortos)
-    ma_result result = ma_sound_init_from_file(&g_audioEngine, filepath, MA_SOUND_FLAG_DECODE, NULL, NULL, &s->sound);
-    
-    if (result != MA_SUCCESS) {
-        printf("[GE] Error cargando sonido: %s\n", filepath);
-        free(s);
-        return NULL;
+// Formatos de texto y XML: una etiqueta por línea (info, common, page, char, kerning)
+static bool GE_ParseBMFontText(GE_BMFontLoad* ld, const unsigned char* data, size_t size) {
+    char line[1024];
+    GE_BMAttr attrs[24];
+    size_t pos = 0;
+    while (pos < size) {
+        size_t length = 0;
+        while (pos < size && data[pos] != '\n') {
+            if (data[pos] != '\r' && length < sizeof(line) - 1) line[length++] = (char)data[pos];
+            pos++;
+        }
+        pos++;
+        line[length] = '\0';
+
+        const char* tag;
+        int n = GE_ParseBMFontLine(line, &tag, attrs, 24);
+        if (strcmp(tag, "info") == 0) {
+            ld->size = abs(GE_BMAttrInt(attrs, n, "size"));
+        } else if (strcmp(tag, "common") == 0) {
+            ld->line_height = GE_BMAttrInt(attrs, n, "lineHeight");
+            ld->base = GE_BMAttrInt(attrs, n, "base");
+            if (GE_BMAttrInt(attrs, n, "packed")) ld->packed = true;
+        } else if (strcmp(tag, "page") == 0) {
+            const char* file = GE_BMAttrStr(attrs, n, "file");
+            if (file && !GE_BMFontSetPage(ld, GE_BMAttrInt(attrs, n, "id"), file, strlen(file))) return false;
+        } else if (strcmp(tag, "char") == 0) {
+            const char* chnl = GE_BMAttrStr(attrs, n, "chnl");
+            if (!GE_BMFontAddChar(ld, (uint32_t)GE_BMAttrInt(attrs, n, "id"),
+                                  GE_BMAttrInt(attrs, n, "x"), GE_BMAttrInt(attrs, n, "y"),
+                                  GE_BMAttrInt(attrs, n, "width"), GE_BMAttrInt(attrs, n, "height"),
+                                  GE_BMAttrInt(attrs, n, "xoffset"), GE_BMAttrInt(attrs, n, "yoffset"),
+                                  GE_BMAttrInt(attrs, n, "xadvance"), GE_BMAttrInt(attrs, n, "page"),
+                                  chnl ? (int)strtol(chnl, NULL, 10) : 15)) return false;
+        } else if (strcmp(tag, "kerning") == 0) {
+            if (!GE_BMFontAddKerning(ld, (uint32_t)GE_BMAttrInt(attrs, n, "first"),
+                                     (uint32_t)GE_BMAttrInt(attrs, n, "second"),
+                                     GE_BMAttrInt(attrs, n, "amount"))) return false;
+        }
     }
-    
-    s->loaded = true;
-    return s;
+    return true;
 }
 
-void GE_UnloadSound(GE_Sound* sound) {
-    if (sound && sound->loaded) {
-        ma_sound_uninit(&sound->sound);
-        free(sound);
-    }
+static inline uint32_t GE_ReadLE(const unsigned char* p, int bytes) {
+    uint32_t v = 0;
+    for (int i = bytes - 1; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
 }
 
-void GE_PlaySound(GE_Sound* sound) {
-    if (sound && sound->loaded) {
-        // Si ya está sonando, lo reiniciamos (para disparos rápidos)
-        if (ma_sound_is_playing(&sound->sound)) {
-            ma_sound_seek_to_pcm_frame(&sound->sound, 0);
+// Formato binario (versión 3): "BMF" 3 y bloques [tipo:1][tamaño:4][datos]
+static bool GE_ParseBMFontBinary(GE_BMFontLoad* ld, const unsigned char* data, size_t size) {
+    size_t pos = 4;
+    while (pos + 5 <= size) {
+        int type = data[pos];
+        size_t length = GE_ReadLE(data + pos + 1, 4);
+        const unsigned char* block = data + pos + 5;
+        pos += 5;
+        if (length > size - pos) return false;
+        pos += length;
+
+        if (type == 1 && length >= 2) {
+            ld->size = abs((int16_t)GE_ReadLE(block, 2));
+        } else if (type == 2 && length >= 11) {
+            ld->line_height = (int)GE_ReadLE(block, 2);
+            ld->base = (int)GE_ReadLE(block + 2, 2);
+            if (block[10] & 0x80) ld->packed = true;
+        } else if (type == 3) {
+            // Nombres terminados en '\0', todos de la misma longitud
+            size_t at = 0;
+            for (int id = 0; at < length; id++) {
+                size_t end = at;
+                while (end < length && block[end]) end++;
+                if (end == at) break;
+                if (!GE_BMFontSetPage(ld, id, (const char*)block + at, end - at)) return false;
+                at = end + 1;
+            }
+        } else if (type == 4) {
+            for (size_t at = 0; at + 20 <= length; at += 20) {
+                const unsigned char* c = block + at;
+                if (!GE_BMFontAddChar(ld, GE_ReadLE(c, 4), (int)GE_ReadLE(c + 4, 2), (int)GE_ReadLE(c + 6, 2),
+                                      (int)GE_ReadLE(c + 8, 2), (int)GE_ReadLE(c + 10, 2),
+                                      (int16_t)GE_ReadLE(c + 12, 2), (int16_t)GE_ReadLE(c + 14, 2),
+                                      (int16_t)GE_ReadLE(c + 16, 2), c[18], c[19])) return false;
+            }
+        } else if (type == 5) {
+            for (size_t at = 0; at + 10 <= length; at += 10) {
+                const unsigned char* k = block + at;
+                if (!GE_BMFontAddKerning(ld, GE_ReadLE(k, 4), GE_ReadLE(k + 4, 4),
+                                         (int16_t)GE_ReadLE(k + 8, 2))) return false;
+            }
         }
-        ma_sound_start(&sound->sound);
     }
+    return true;
 }
 
-void GE_StopSound(GE_Sound* sound) {
-    if (sound && sound->loaded) {
-        ma_sound_stop(&sound->sound);
-        ma_sound_seek_to_pcm_frame(&sound->sound, 0); // Rebobinar al inicio
+// Página del atlas: escala de grises -> cobertura A8 (alpha x brillo); color -> RGBA
+static GE_Sprite* GE_LoadBMFontPage(const char* path) {
+    int w, h, channels;
+    unsigned char* rgba = stbi_load(path, &w, &h, &channels, 4);
+    if (!rgba) {
+        printf("[GE] Error: No se pudo cargar la pagina de fuente '%s'\n", path);
+        return NULL;
+    }
+    GE_Sprite* sprite = (GE_Sprite*)calloc(1, sizeof(GE_Sprite));
+    if (!sprite) {
+        stbi_image_free(rgba);
+        return NULL;
     }
-}
 
-void GE_SetVolume(GE_Sound* sound, float volume) {
-    if (sound && sound->loaded) {
-        ma_sound_set_volume(&sound->sound, volume);
+    size_t texels = (size_t)w * h;
+    bool grey = true;
+    for (size_t i = 0; i < texels && grey; i++) {
+        const unsigned char* px = &rgba[i * 4];
+        if (px[3] && (px[0] != px[1] || px[1] != px[2])) grey = false;
     }
+    unsigned char* coverage = grey ? (unsigned char*)malloc(texels) : NULL;
+    if (coverage) {
+        for (size_t i = 0; i < texels; i++) coverage[i] = (unsigned char)((rgba[i * 4 + 3] * rgba[i * 4] + 127) / 255);
+        stbi_image_free(rgba);
+        GE_InitSpriteCoverage(sprite, w, h, coverage);
+    } else {
+        GE_InitSpriteFull(sprite, w, h, rgba, true);
+        GE_DetectOpaque(sprite);
+    }
+    return sprite;
 }
 
-void GE_SetLooping(GE_Sound* sound, bool loop) {
-    if (sound && sound->loaded) {
-        ma_sound_set_looping(&sound->sound, loop);
+// Páginas, métricas verticales y kerning una vez leído el descriptor
+static bool GE_FinishBMFont(GE_BMFontLoad* ld, const char* filepath) {
+    GE_Font* font = ld->font;
+    if (ld->packed) {
+        printf("[GE] Error: '%s' reparte glifos por canales (packed), no soportado\n", filepath);
+        return false;
+    }
+    if (ld->line_height <= 0 || ld->page_count == 0) {
+        printf("[GE] Error: '%s' no es una fuente BMFont valida\n", filepath);
+        return false;
     }
-}
 
-// Nota: Deberíamos tener una función GE_CloseAudio() para llamar a ma_engine_uninit
-// Puedes agregarla dentro de GE_Close() si quieres ser estricto con la memoria.
+    // Las páginas se buscan junto al .fnt
+    const char* slash = strrchr(filepath, '/');
+    const char* backslash = strrchr(filepath, '\\');
+    if (backslash > slash) slash = backslash;
+    size_t dir = slash ? (size_t)(slash - filepath + 1) : 0;
+
+    font->pages = (GE_GlyphPage*)calloc(ld->page_count, sizeof(GE_GlyphPage));
+    if (!font->pages) return false;
+    font->page_count = ld->page_count;
+    for (int i = 0; i < ld->page_count; i++) {
+        if (!ld->pages[i]) continue;
+        char* path = (char*)malloc(dir + strlen(ld->pages[i]) + 1);
+        if (!path) return false;
+        memcpy(path, filepath, dir);
+        strcpy(path + dir, ld->pages[i]);
+        font->pages[i].sprite = GE_LoadBMFontPage(path);
+        free(path);
+        if (!font->pages[i].sprite) return false;
+        font->used += (size_t)font->pages[i].sprite->pitch * font->pages[i].sprite->height;
+    }
 
-// ============================================================================
-// 7. SISTEMA DE TEXTO (CORREGIDO Y DEFINITIVO)
-// ============================================================================
+    font->size = ld->size > 0 ? (float)ld->size : (float)ld->line_height;
+    font->scale = 1.0f;
+    font->ascent = (float)ld->base;
+    font->descent = (float)(ld->base - ld->line_height);
+    font->line_height = (float)ld->line_height;
+    for (int i = 0; i < font->glyph_count; i++) {
+        GE_Glyph* g = &font->glyphs[i];
+        g->yoff = (int16_t)(g->yoff - ld->base);
+        const GE_Sprite* page = (g->page >= 0 && g->page < font->page_count) ? font->pages[g->page].sprite : NULL;
+        if (!page || g->w <= 0 || g->h <= 0 || g->x + g->w > page->width || g->y + g->h > page->height) {
+            g->w = g->h = 0; // Sin tinta utilizable: solo cuenta el avance
+            g->page = -1;
+        }
+    }
 
-// 1. Definición de la Estructura (Debe ir PRIMERO)
-struct GE_Font {
-    stbtt_bakedchar cdata[96]; // Datos de los caracteres (ASCII 32 a 126)
-    GE_Sprite* texture;        // El atlas de la fuente (imagen)
-    float size;                // Tamaño base
-};
+    for (int i = 0; i < ld->kerning_count; i++) {
+        int32_t a = GE_CodepointMapGet(&font->map, ld->kernings[i].first);
+        int32_t b = GE_CodepointMapGet(&font->map, ld->kernings[i].second);
+        if (a < 0 || b < 0) continue;
+        if (!GE_PutKernPair(&font->kern, GE_KernKey(a, b), ld->kernings[i].amount)) return false;
+        font->kern.mode = GE_KERN_TABLE;
+    }
+    return true;
+}
 
-// 2. Función de Carga
-GE_Font* GE_LoadFont(const char* filepath, float size) {
-    FILE* f = fopen(filepath, "rb");
-    if (!f) {
-        printf("[GE] ERROR CRITICO: No se encontro la fuente '%s'.\n", filepath);
-        return NULL; 
+GE_Font* GE_LoadBitmapFont(const char* filepath) {
+    if (!filepath) return NULL;
+    size_t size = 0;
+    bool mapped = false;
+    unsigned char* data = GE_MapFile(filepath, &size, &mapped);
+    if (!data) {
+        printf("[GE] Error: No se pudo abrir la fuente '%s'\n", filepath);
+        return NULL;
     }
-    
-    // Leer archivo completo
-    fseek(f, 0, SEEK_END);
-    long fsize = ftell(f);
-    fseek(f, 0, SEEK_SET);
-    unsigned char* ttf_buffer = (unsigned char*)malloc(fsize);
-    fread(ttf_buffer, 1, fsize, f);
-    fclose(f);
 
-    // Crear bitmap temporal
-    int width = 512;
-    int height = 512;
-    unsigned char* temp_bitmap = (unsigned char*)malloc(width * height);
+    GE_BMFontLoad ld;
+    memset(&ld, 0, sizeof(ld));
+    ld.font = (GE_Font*)calloc(1, sizeof(GE_Font));
+    bool ok = ld.font != NULL;
+    if (ok) {
+        ld.font->budget = GE_FONT_DEFAULT_BUDGET;
+        GE_InitCodepointMap(&ld.font->map);
+        if (size >= 4 && memcmp(data, "BMF", 3) == 0) {
+            ok = data[3] == 3;
+            if (!ok) printf("[GE] Error: '%s' usa una version de BMFont binario no soportada (%d)\n", filepath, data[3]);
+            else ok = GE_ParseBMFontBinary(&ld, data, size);
+        } else {
+            ok = GE_ParseBMFontText(&ld, data, size);
+        }
+        ok = ok && GE_FinishBMFont(&ld, filepath);
+    }
+    GE_UnmapFile(data, size, mapped);
 
-    GE_Font* font = (GE_Font*)calloc(1, sizeof(GE_Font));
-    font->size = size;
+    for (int i = 0; i < ld.page_count; i++) free(ld.pages[i]);
+    free(ld.pages);
+    free(ld.kernings);
+    if (!ok) {
+        GE_UnloadFont(ld.font);
+        return NULL;
+    }
+    return ld.font;
+}
 
-    // "Hornear" caracteres en el bitmap
-    stbtt_BakeFontBitmap(ttf_buffer, 0, size, temp_bitmap, width, height, 32, 96, font->cdata);
-    free(ttf_buffer); 
+// --- TEXTO SDF ---
+// Una fuente SDF guarda cada glifo una sola vez, a su tamaño base, como campo de
+// distancias con signo (stbtt_GetGlyphSDF): 128 es el borde y cada GE_SDF_PADDING
+// texels fuera del borde el valor baja hasta 0. Al dibujar a cualquier escala se
+// interpola la distancia (bilineal) y se convierte a cobertura con un borde suavizado
+// de 'smoothing' píxeles. Contorno y resplandor son otros umbrales sobre la misma
+// distancia, así que casi no cuestan nada; su alcance máximo es el relleno del campo
+// (GE_SDF_PADDING texels, escalado al tamaño de dibujo).
+
+typedef struct {
+    float r, g, b, a;        // Alpha premultiplicado, 0..1
+} GE_SDFColor;
+
+typedef struct {
+    float dist_scale;        // Texels de distancia por unidad de valor del campo
+    float scale;             // Píxeles destino por texel
+    float smoothing, outline, glow;
+    GE_SDFColor fill, outline_color, glow_color;
+    GE_BlendMode mode;
+} GE_SDFParams;
+
+static inline GE_SDFColor GE_SDFUnpack(GE_Color c, float alpha) {
+    float a = ((c >> 24) & 0xFF) / 255.0f * alpha;
+    return (GE_SDFColor){ ((c >> 16) & 0xFF) / 255.0f * a, ((c >> 8) & 0xFF) / 255.0f * a, (c & 0xFF) / 255.0f * a, a };
+}
 
-    // Convertir bitmap gris a Sprite RGBA (Blanco con Alpha)
-    font->texture = (GE_Sprite*)malloc(sizeof(GE_Sprite));
-    font->texture->width = width;
-    font->texture->height = height;
-    font->texture->channels = 4;
-    font->texture->data = (unsigned char*)malloc(width * height * 4);
+// Cobertura del borde a distancia 'd' (píxeles, positiva dentro) con suavizado 'aa'
+static inline float GE_SDFCoverage(float d, float aa) {
+    float c = d / aa + 0.5f;
+    return c < 0 ? 0 : (c > 1 ? 1 : c);
+}
 
-    for (int i = 0; i < width * height; i++) {
-        font->texture->data[i*4 + 0] = 255; // R
-        font->texture->data[i*4 + 1] = 255; // G
-        font->texture->data[i*4 + 2] = 255; // B
-        font->texture->data[i*4 + 3] = temp_bitmap[i]; // Alpha (transparencia)
+// Dibuja un glifo SDF con su esquina superior izquierda en (gx, gy)
+static void GE_DrawGlyphSDF(GE_Context* ctx, const GE_Sprite* page, const GE_Glyph* g, float gx, float gy, const GE_SDFParams* p) {
+    int bx0, by0, bx1, by1;
+    GE_BlitBounds(ctx, &bx0, &by0, &bx1, &by1);
+    int x0 = (int)floorf(gx), y0 = (int)floorf(gy);
+    int x1 = (int)ceilf(gx + g->w * p->scale), y1 = (int)ceilf(gy + g->h * p->scale);
+    if (x0 < bx0) x0 = bx0;
+    if (y0 < by0) y0 = by0;
+    if (x1 > bx1) x1 = bx1;
+    if (y1 > by1) y1 = by1;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    float inv = 1.0f / p->scale;
+    float px_dist = p->dist_scale * p->scale; // Píxeles destino por unidad del campo
+    const unsigned char* base = page->data + g->y * page->pitch + g->x;
+
+    for (int y = y0; y < y1; y++) {
+        // Centro del píxel en texels del glifo, recortado a su rect (el borde ya es "fuera")
+        float v = (y + 0.5f - gy) * inv - 0.5f;
+        if (v < 0) v = 0;
+        if (v > g->h - 1) v = (float)(g->h - 1);
+        int ty = (int)v;
+        int ty1 = ty + 1 < g->h ? ty + 1 : ty;
+        float fy = v - ty;
+        const unsigned char* r0 = base + ty * page->pitch;
+        const unsigned char* r1 = base + ty1 * page->pitch;
+        uint32_t* dst = &ctx->render_buffer[y * ctx->render_width];
+
+        for (int x = x0; x < x1; x++) {
+            float u = (x + 0.5f - gx) * inv - 0.5f;
+            if (u < 0) u = 0;
+            if (u > g->w - 1) u = (float)(g->w - 1);
+            int tx = (int)u;
+            int tx1 = tx + 1 < g->w ? tx + 1 : tx;
+            float fx = u - tx;
+            float top = r0[tx] + (r0[tx1] - r0[tx]) * fx;
+            float bottom = r1[tx] + (r1[tx1] - r1[tx]) * fx;
+            float d = (top + (bottom - top) * fy - 128.0f) * px_dist;
+
+            // Capas de arriba abajo: relleno, contorno y resplandor (premultiplicado)
+            float fill = GE_SDFCoverage(d, p->smoothing);
+            GE_SDFColor c = { p->fill.r * fill, p->fill.g * fill, p->fill.b * fill, p->fill.a * fill };
+            float edge = d;
+            if (p->outline > 0) {
+                edge = d + p->outline;
+                float k = GE_SDFCoverage(edge, p->smoothing) * (1.0f - c.a);
+                c.r += p->outline_color.r * k; c.g += p->outline_color.g * k;
+                c.b += p->outline_color.b * k; c.a += p->outline_color.a * k;
+            }
+            if (p->glow > 0 && edge < p->smoothing * 0.5f) {
+                float t = 1.0f + edge / p->glow; // 1 en el borde exterior, 0 a 'glow' píxeles
+                if (t > 0) {
+                    float k = t * t * (1.0f - c.a);
+                    c.r += p->glow_color.r * k; c.g += p->glow_color.g * k;
+                    c.b += p->glow_color.b * k; c.a += p->glow_color.a * k;
+                }
+            }
+            if (c.a < 0.5f / 255.0f) continue;
+
+            // De vuelta a 0xAARRGGBB en alpha recto para el modo de mezcla activo
+            float ia = 255.0f / c.a;
+            uint32_t a8 = (uint32_t)(c.a * 255.0f + 0.5f);
+            uint32_t r8 = (uint32_t)(c.r * ia + 0.5f), g8 = (uint32_t)(c.g * ia + 0.5f), b8 = (uint32_t)(c.b * ia + 0.5f);
+            if (r8 > 255) r8 = 255;
+            if (g8 > 255) g8 = 255;
+            if (b8 > 255) b8 = 255;
+            GE_BlendPixel(&dst[x], (a8 << 24) | (r8 << 16) | (g8 << 8) | b8, p->mode);
+        }
     }
+}
 
-    free(temp_bitmap);
-    return font;
+// --- CACHÉ DE MAQUETACIÓN DE TEXTO ---
+// Los textos que se repiten cada frame (HUD, menús, diálogos) se decodifican y maquetan
+// una sola vez: la cadena se guarda con sus líneas (saltos '\n' y ajuste de palabras)
+// y los glifos con tinta de cada una con su posición. Dibujar, medir y alinear salen
+// del mismo resultado. La clave es cadena + ancho de ajuste. Una entrada que lleva
+// GE_TEXT_RUN_TTL frames sin usarse se libera, y con la tabla llena se recicla la
+// usada hace más tiempo.
+
+static uint32_t GE_HashText(const char* text, int* out_length) {
+    uint32_t h = 2166136261u; // FNV-1a
+    const unsigned char* s = (const unsigned char*)text;
+    int n = 0;
+    for (; s[n]; n++) h = (h ^ s[n]) * 16777619u;
+    *out_length = n;
+    return h;
 }
 
-void GE_UnloadFont(GE_Font* font) {
-    if (font) {
-        if (font->texture) GE_UnloadSprite(font->texture);
-        free(font);
+static void GE_UnlinkTextRun(GE_Font* font, int index) {
+    int32_t* link = &font->run_buckets[font->runs[index].hash & (GE_TEXT_RUN_BUCKETS - 1)];
+    while (*link >= 0) {
+        if (*link == index) {
+            *link = font->runs[index].next;
+            return;
+        }
+        link = &font->runs[*link].next;
     }
 }
 
-// 3. Función de Medición (CRUCIAL PARA ALINEAR)
-GE_Point GE_MeasureText(GE_Font* font, const char* text) {
-    if (!font || !text) return (GE_Point){0,0};
-    
-    float x = 0;
-    float y = 0;
+static void GE_ReleaseTextRun(GE_Font* font, int index) {
+    GE_TextRun* run = &font->runs[index];
+    if (!run->text) return;
+    GE_UnlinkTextRun(font, index);
+    free(run->text);
+    free(run->glyphs);
+    free(run->lines);
+    memset(run, 0, sizeof(GE_TextRun));
+}
+
+// Cierra la línea en curso con los glifos [first, end)
+static bool GE_PushRunLine(GE_TextRun* run, int first, int end, float width) {
+    if (run->line_count == run->line_capacity) {
+        int new_cap = run->line_capacity ? run->line_capacity * 2 : 4;
+        GE_RunLine* list = (GE_RunLine*)realloc(run->lines, new_cap * sizeof(GE_RunLine));
+        if (!list) return false;
+        run->lines = list;
+        run->line_capacity = new_cap;
+    }
+    run->lines[run->line_count++] = (GE_RunLine){ first, end - first, width };
+    if (width > run->width) run->width = width;
+    return true;
+}
+
+// Decodifica y coloca los glifos de 'text' (sin rasterizar). Con wrap_width > 0 la línea
+// se corta en el último espacio antes de pasarse; una palabra más larga que la línea se
+// corta entre letras. Los espacios del corte no cuentan en el ancho de ninguna línea.
+static bool GE_LayoutTextRun(GE_Font* font, GE_TextRun* run, const char* text, float wrap_width) {
+    run->glyph_count = 0;
+    run->line_count = 0;
+    run->width = 0;
+    int line_first = 0;
+    float pen = 0, line_end = 0;
+    int brk = -1;            // Primer glifo de la palabra siguiente al último espacio (-1 = ninguno)
+    float brk_pen = 0, brk_end = 0;
+    bool after_space = false; // El próximo glifo empieza palabra (posible corte)
+    float space_end = 0;
+    int prev = -1;            // Glifo anterior en la línea (kerning)
     const char* ptr = text;
-    
+
     while (*ptr) {
-        if (*ptr >= 32 && *ptr < 128) {
-            stbtt_aligned_quad q;
-            // GetBakedQuad AVANZA la variable 'x' automáticamente
-            stbtt_GetBakedQuad(font->cdata, 512, 512, *ptr - 32, &x, &y, &q, 1);
+        uint32_t cp = GE_DecodeUTF8(&ptr);
+        if (cp == '\n') {
+            if (!GE_PushRunLine(run, line_first, run->glyph_count, line_end)) return false;
+            line_first = run->glyph_count;
+            pen = line_end = 0;
+            brk = -1;
+            after_space = false;
+            prev = -1;
+            continue;
         }
-        ptr++;
+        if (cp < 32) continue;
+        int index = GE_FindGlyph(font, cp); // Solo métricas
+        if (index < 0) continue;
+        const GE_Glyph* g = &font->glyphs[index];
+
+        if (prev >= 0) pen += GE_GetKerning(font, &font->glyphs[prev], g) * font->scale;
+        prev = index;
+
+        if (cp == ' ') {
+            pen += g->advance;
+            if (line_end > 0 && !after_space) { // Los espacios al inicio de línea son sangría, no corte
+                after_space = true;
+                space_end = line_end;
+            }
+            continue;
+        }
+        if (after_space) {
+            // El corte va justo antes de esta palabra (ya con el kerning del espacio)
+            brk = run->glyph_count;
+            brk_pen = pen;
+            brk_end = space_end;
+            after_space = false;
+        }
+
+        if (wrap_width > 0 && line_end > 0 && pen + g->advance > wrap_width) {
+            if (brk >= 0) {
+                // La palabra en curso baja entera a la línea siguiente
+                if (!GE_PushRunLine(run, line_first, brk, brk_end)) return false;
+                for (int i = brk; i < run->glyph_count; i++) run->glyphs[i].x -= brk_pen;
+                line_first = brk;
+                pen -= brk_pen;
+                line_end = pen;
+            } else {
+                if (!GE_PushRunLine(run, line_first, run->glyph_count, line_end)) return false;
+                line_first = run->glyph_count;
+                pen = line_end = 0; // Sin el kerning con la letra que quedó arriba
+            }
+            brk = -1;
+        }
+
+        if (g->w > 0 && g->h > 0) {
+            if (run->glyph_count == run->glyph_capacity) {
+                int new_cap = run->glyph_capacity ? run->glyph_capacity * 2 : 16;
+                GE_RunGlyph* list = (GE_RunGlyph*)realloc(run->glyphs, new_cap * sizeof(GE_RunGlyph));
+                if (!list) return false;
+                run->glyphs = list;
+                run->glyph_capacity = new_cap;
+            }
+            run->glyphs[run->glyph_count++] = (GE_RunGlyph){ index, pen };
+        }
+        pen += g->advance;
+        line_end = pen;
     }
-    // x contiene el ancho total acumulado
-    return (GE_Point){ x, font->size }; 
+    return GE_PushRunLine(run, line_first, run->glyph_count, line_end);
 }
 
-// 4. Función de Dibujado Simple
-void GE_DrawText(GE_Context* ctx, GE_Font* font, const char* text, float x, float y, GE_Color color) {
-    if (!font || !text) return;
+// Maquetación de 'text' con ese ancho de ajuste (de la caché o nueva). NULL sin memoria.
+// El puntero vale hasta la siguiente llamada con otra clave.
+static GE_TextRun* GE_GetTextRun(GE_Font* font, const char* text, float wrap_width) {
+    if (!font->runs) {
+        font->runs = (GE_TextRun*)calloc(GE_TEXT_RUN_SLOTS, sizeof(GE_TextRun));
+        if (!font->runs) return NULL;
+        for (int i = 0; i < GE_TEXT_RUN_BUCKETS; i++) font->run_buckets[i] = -1;
+    }
+    if (wrap_width < 0) wrap_width = 0;
+
+    int length;
+    uint32_t hash = GE_HashText(text, &length);
+    uint32_t wrap_bits;
+    memcpy(&wrap_bits, &wrap_width, sizeof(wrap_bits));
+    hash ^= wrap_bits * 2654435761u;
+    for (int32_t i = font->run_buckets[hash & (GE_TEXT_RUN_BUCKETS - 1)]; i >= 0; i = font->runs[i].next) {
+        GE_TextRun* run = &font->runs[i];
+        if (run->hash == hash && run->length == length && run->wrap_width == wrap_width &&
+            memcmp(run->text, text, length) == 0) {
+            run->last_frame = g_frame_index;
+            return run;
+        }
+    }
 
-    float startX = x; // Guardamos X original por si quisiéramos saltos de línea (futuro)
-    const char* ptr = text;
+    // Hueco: libre, o el menos reciente. De paso se liberan las entradas caducadas.
+    int slot = -1;
+    for (int i = 0; i < GE_TEXT_RUN_SLOTS; i++) {
+        GE_TextRun* run = &font->runs[i];
+        if (run->text && g_frame_index - run->last_frame > GE_TEXT_RUN_TTL) GE_ReleaseTextRun(font, i);
+        if (!run->text) {
+            if (slot < 0 || font->runs[slot].text) slot = i;
+        } else if (slot < 0 || (font->runs[slot].text && run->last_frame < font->runs[slot].last_frame)) {
+            slot = i;
+        }
+    }
+    GE_ReleaseTextRun(font, slot);
+
+    GE_TextRun* run = &font->runs[slot];
+    run->text = (char*)malloc(length + 1);
+    if (!run->text || !GE_LayoutTextRun(font, run, text, wrap_width)) {
+        free(run->text);
+        free(run->glyphs);
+        free(run->lines);
+        memset(run, 0, sizeof(GE_TextRun));
+        return NULL;
+    }
+    memcpy(run->text, text, length + 1);
+    run->length = length;
+    run->wrap_width = wrap_width;
+    run->hash = hash;
+    run->last_frame = g_frame_index;
+    int32_t* bucket = &font->run_buckets[hash & (GE_TEXT_RUN_BUCKETS - 1)];
+    run->next = *bucket;
+    *bucket = slot;
+    return run;
+}
 
-    while (*ptr) {
-        if (*ptr >= 32 && *ptr < 128) {
-            stbtt_aligned_quad q;
-            // GetBakedQuad calcula las coordenadas de recorte (src) y pantalla (dst)
-            stbtt_GetBakedQuad(font->cdata, 512, 512, *ptr - 32, &x, &y, &q, 1);
-            
-            GE_Rect src = { q.s0 * 512, q.t0 * 512, (q.s1 - q.s0) * 512, (q.t1 - q.t0) * 512 };
-            GE_Rect dst = { q.x0, q.y0, q.x1 - q.x0, q.y1 - q.y0 };
+// Dibuja las líneas [first, last) de una maquetación. 'x' es el ancla horizontal de
+// cada línea según 'align' y 'y' la línea base de la línea 'first'. 'scale' agranda o
+// reduce respecto al tamaño base: nítido con fuentes SDF, vecino más cercano con las demás.
+static void GE_DrawTextRun(GE_Context* ctx, GE_Font* font, const GE_TextRun* run, int first, int last,
+                           float x, float y, GE_TextAlign align, GE_Color color, float scale, const GE_TextStyle* style) {
+    font->tick++;
+    GE_Tint t = GE_MakeTint(color);
+    GE_SDFParams sdf = {0};
+    if (font->sdf) {
+        GE_FlushRendering(ctx); // Se rasteriza en el hilo principal: lo grabado antes va primero
+        sdf.dist_scale = GE_SDF_PADDING / 128.0f;
+        sdf.scale = scale;
+        sdf.smoothing = (style && style->smoothing > 0) ? style->smoothing : 1.0f;
+        sdf.outline = style ? style->outline : 0;
+        sdf.glow = style ? style->glow : 0;
+        sdf.fill = GE_SDFUnpack(color, 1.0f);
+        sdf.outline_color = GE_SDFUnpack(style ? style->outline_color : 0, 1.0f);
+        sdf.glow_color = GE_SDFUnpack(style ? style->glow_color : 0, 1.0f);
+        sdf.mode = ctx->blend_mode;
+    }
 
-            GE_DrawSpriteEx(ctx, font->texture, src, dst, color);
+    for (int l = first; l < last; l++, y += font->line_height * scale) {
+        const GE_RunLine* line = &run->lines[l];
+        float line_x = x;
+        if (align == GE_ALIGN_CENTER) line_x -= line->width * scale / 2.0f;
+        else if (align == GE_ALIGN_RIGHT) line_x -= line->width * scale;
+
+        for (int i = line->first; i < line->first + line->count; i++) {
+            GE_Glyph* g = &font->glyphs[run->glyphs[i].glyph];
+            if (g->page < 0 && !GE_RasterizeGlyph(ctx, font, g)) continue;
+            GE_GlyphPage* page = &font->pages[g->page];
+            page->last_used = font->tick;
+            float gx = line_x + (run->glyphs[i].x + g->xoff) * scale;
+            float gy = y + g->yoff * scale;
+            if (font->sdf) {
+                GE_DrawGlyphSDF(ctx, page->sprite, g, gx, gy, &sdf);
+                continue;
+            }
+            // Mismo redondeo que stbtt_GetBakedQuad
+            int dx = (int)floorf(gx + 0.5f);
+            int dy = (int)floorf(gy + 0.5f);
+            int dw = g->w, dh = g->h;
+            if (scale != 1.0f) {
+                dw = (int)floorf(gx + g->w * scale + 0.5f) - dx;
+                dh = (int)floorf(gy + g->h * scale + 0.5f) - dy;
+                if (dw <= 0 || dh <= 0) continue;
+            }
+            GE_BlitSpriteRegion(ctx, page->sprite, g->x, g->y, g->w, g->h, dx, dy, dw, dh, GE_FLIP_NONE, &t);
         }
-        ptr++;
     }
 }
 
-// 5. Función de Alineación (USA LA MEDICIÓN)
-//                                                                    AQUI ESTABA EL ERROR
-//                                                                            v
+// 3. Función de Medición (CRUCIAL PARA ALINEAR)
+// Ancho de la línea más larga y alto real: de la cima de la primera línea al fondo de la última
+GE_Point GE_MeasureText(GE_Font* font, const char* text) {
+    font = GE_ReadyFont(font);
+    if (!font || !text) return (GE_Point){0,0};
+    GE_TextRun* run = GE_GetTextRun(font, text, 0);
+    if (!run) return (GE_Point){0,0};
+    float height = (run->line_count - 1) * font->line_height + font->ascent - font->descent;
+    return (GE_Point){ run->width, height }; 
+}
+
+// 4. Función de Dibujado Simple ('y' es la línea base de la primera línea)
+void GE_DrawText(GE_Context* ctx, GE_Font* font, const char* text, float x, float y, GE_Color color) {
+    font = GE_ReadyFont(font);
+    if (!ctx || !font || !text) return;
+    GE_TextRun* run = GE_GetTextRun(font, text, 0);
+    if (run) GE_DrawTextRun(ctx, font, run, 0, run->line_count, x, y, GE_ALIGN_LEFT, color, 1.0f, NULL);
+}
+
+// 5. Función de Alineación (una sola maquetación para medir y dibujar; cada línea se alinea aparte)
 void GE_DrawTextAligned(GE_Context* c, GE_Font* f, const char* t, float x, float y, GE_TextAlign align, GE_Color col) {
+    f = GE_ReadyFont(f);
     if (!c || !f || !t) return;
+    GE_TextRun* run = GE_GetTextRun(f, t, 0);
+    if (run) GE_DrawTextRun(c, f, run, 0, run->line_count, x, y, align, col, 1.0f, NULL);
+}
 
-    // Alineación 0 = Izquierda (GE_ALIGN_LEFT)
-    if (align == 0) {
-        GE_DrawText(c, f, t, x, y, col);
+// 6. Caja de texto: párrafos con ajuste de palabras dentro de 'rect'.
+// La primera línea se apoya en el borde superior (base = y + ascent); las líneas que no
+// caben enteras en el alto de la caja no se dibujan (rect.h <= 0 = sin límite).
+void GE_DrawTextBox(GE_Context* ctx, GE_Font* font, const char* text, GE_Rect rect, GE_TextAlign align, bool wrap, GE_Color color) {
+    font = GE_ReadyFont(font);
+    if (!ctx || !font || !text) return;
+    GE_TextRun* run = GE_GetTextRun(font, text, (wrap && rect.w > 0) ? rect.w : 0);
+    if (!run) return;
+
+    int lines = run->line_count;
+    if (rect.h > 0) {
+        float room = rect.h - (font->ascent - font->descent);
+        lines = room < 0 ? 0 : 1 + (int)(room / font->line_height);
+        if (lines > run->line_count) lines = run->line_count;
+    }
+
+    float x = rect.x;
+    if (align == GE_ALIGN_CENTER) x += rect.w / 2.0f;
+    else if (align == GE_ALIGN_RIGHT) x += rect.w;
+    GE_DrawTextRun(ctx, font, run, 0, lines, x, rect.y + font->ascent, align, color, 1.0f, NULL);
+}
+
+// 7. Texto a cualquier tamaño ('y' es la línea base). Con fuentes SDF el estilo añade
+// contorno y resplandor; con las demás se escala el atlas (vecino más cercano/bilineal).
+void GE_DrawTextSDF(GE_Context* ctx, GE_Font* font, const char* text, float x, float y, float size, GE_Color color, const GE_TextStyle* style) {
+    font = GE_ReadyFont(font);
+    if (!ctx || !font || !text || size <= 0) return;
+    GE_TextRun* run = GE_GetTextRun(font, text, 0);
+    if (run) GE_DrawTextRun(ctx, font, run, 0, run->line_count, x, y, GE_ALIGN_LEFT, color, size / font->size, style);
+}
+
+// 8. Objetos de texto: el texto se maqueta y se mezcla una sola vez en un sprite
+// premultiplicado recortado a la tinta; cada frame es un único blit 1:1. Se vuelve a
+// generar (en el siguiente dibujo) solo si cambian el texto o el color.
+struct GE_TextObject {
+    GE_Font* font;
+    char* text;
+    GE_Color color;
+    GE_Sprite* sprite;       // NULL si el texto no tiene tinta
+    GE_Font* drawn_font;     // Con la que se generó (el respaldo mientras 'font' carga)
+    int off_x, off_y;        // Esquina del sprite respecto al origen (línea base de la primera línea)
+    bool dirty;
+
+    // Versiones anteriores que una pasada diferida en curso aún puede estar usando
+    GE_Sprite** retired;
+    int retired_count, retired_capacity;
+};
+
+GE_TextObject* GE_CreateTextObject(GE_Font* font, const char* text, GE_Color color) {
+    if (!font || !text) return NULL;
+    GE_TextObject* obj = (GE_TextObject*)calloc(1, sizeof(GE_TextObject));
+    if (!obj) return NULL;
+    obj->text = (char*)malloc(strlen(text) + 1);
+    if (!obj->text) {
+        free(obj);
+        return NULL;
+    }
+    strcpy(obj->text, text);
+    obj->font = font;
+    obj->color = color;
+    obj->dirty = true;
+    return obj;
+}
+
+void GE_SetTextObjectText(GE_TextObject* obj, const char* text) {
+    if (!obj || !text || strcmp(obj->text, text) == 0) return;
+    char* copy = (char*)malloc(strlen(text) + 1);
+    if (!copy) return;
+    strcpy(copy, text);
+    free(obj->text);
+    obj->text = copy;
+    obj->dirty = true;
+}
+
+void GE_SetTextObjectColor(GE_TextObject* obj, GE_Color color) {
+    if (!obj || obj->color == color) return;
+    obj->color = color;
+    obj->dirty = true;
+}
+
+static void GE_FreeRetiredTextSprites(GE_TextObject* obj) {
+    for (int i = 0; i < obj->retired_count; i++) GE_UnloadSprite(obj->retired[i]);
+    obj->retired_count = 0;
+}
+
+// Genera el sprite. 'ctx' es el contexto donde se va a dibujar: los glifos se rasterizan
+// con sus protecciones (pasada diferida, render multihilo) antes de mezclar a un lienzo propio.
+static void GE_RenderTextObject(GE_Context* ctx, GE_TextObject* obj) {
+    GE_Font* font = GE_ReadyFont(obj->font);
+    obj->drawn_font = font;
+    obj->dirty = false;
+
+    // La versión anterior puede estar grabada en la pasada diferida o en la cola de render
+    GE_FlushRendering(ctx);
+    if (obj->sprite) {
+        bool keep = ctx->deferred && ctx->deferred->recording;
+        if (keep && obj->retired_count == obj->retired_capacity) {
+            int new_cap = obj->retired_capacity ? obj->retired_capacity * 2 : 4;
+            GE_Sprite** list = (GE_Sprite**)realloc(obj->retired, new_cap * sizeof(GE_Sprite*));
+            if (list) {
+                obj->retired = list;
+                obj->retired_capacity = new_cap;
+            } else {
+                keep = false;
+            }
+        }
+        if (keep) obj->retired[obj->retired_count++] = obj->sprite;
+        else GE_UnloadSprite(obj->sprite);
+        obj->sprite = NULL;
+    }
+
+    if (!font) return;
+    GE_TextRun* run = GE_GetTextRun(font, obj->text, 0);
+    if (!run) return;
+
+    // Glifos en el atlas y caja de tinta con el mismo redondeo que el dibujo
+    font->tick++;
+    int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+    bool any = false;
+    for (int l = 0; l < run->line_count; l++) {
+        const GE_RunLine* line = &run->lines[l];
+        float y = l * font->line_height;
+        for (int i = line->first; i < line->first + line->count; i++) {
+            GE_Glyph* g = &font->glyphs[run->glyphs[i].glyph];
+            if (g->page < 0 && !GE_RasterizeGlyph(ctx, font, g)) continue;
+            font->pages[g->page].last_used = font->tick;
+            float gx = run->glyphs[i].x + g->xoff, gy = y + g->yoff;
+            int gx0 = font->sdf ? (int)floorf(gx) : (int)floorf(gx + 0.5f);
+            int gy0 = font->sdf ? (int)floorf(gy) : (int)floorf(gy + 0.5f);
+            int gx1 = font->sdf ? (int)ceilf(gx + g->w) : gx0 + g->w;
+            int gy1 = font->sdf ? (int)ceilf(gy + g->h) : gy0 + g->h;
+            if (!any || gx0 < x0) x0 = gx0;
+            if (!any || gy0 < y0) y0 = gy0;
+            if (!any || gx1 > x1) x1 = gx1;
+            if (!any || gy1 > y1) y1 = gy1;
+            any = true;
+        }
+    }
+    if (!any) return;
+
+    // Lienzo transparente: el modo ALPHA acumula cobertura y deja el color premultiplicado
+    int w = x1 - x0, h = y1 - y0;
+    GE_Context* canvas = (GE_Context*)calloc(1, sizeof(GE_Context));
+    uint32_t* pixels = (uint32_t*)calloc((size_t)w * h, sizeof(uint32_t));
+    unsigned char* data = (unsigned char*)malloc((size_t)w * h * 4);
+    GE_Sprite* sprite = (GE_Sprite*)calloc(1, sizeof(GE_Sprite));
+    if (!canvas || !pixels || !data || !sprite) {
+        free(canvas); free(pixels); free(data); free(sprite);
+        return;
+    }
+    canvas->render_width = w;
+    canvas->render_height = h;
+    canvas->render_buffer = pixels;
+    canvas->blend_mode = GE_BLEND_ALPHA;
+    GE_DrawTextRun(canvas, font, run, 0, run->line_count, (float)-x0, (float)-y0, GE_ALIGN_LEFT, obj->color, 1.0f, NULL);
+
+    // Recorte a la tinta real (las cajas SDF incluyen su margen de distancias)
+    int tx0 = w, ty0 = h, tx1 = 0, ty1 = 0;
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            if (!(pixels[y * w + x] >> 24)) continue;
+            if (x < tx0) tx0 = x;
+            if (x >= tx1) tx1 = x + 1;
+            if (y < ty0) ty0 = y;
+            ty1 = y + 1;
+        }
+    }
+    if (tx0 >= tx1) {
+        free(pixels); free(canvas); free(data); free(sprite);
         return;
     }
 
-    GE_Point size = GE_MeasureText(f, t);
-    float finalX = x;
+    int tw = tx1 - tx0, th = ty1 - ty0;
+    for (int y = 0; y < th; y++) {
+        const uint32_t* src = &pixels[(ty0 + y) * w + tx0];
+        unsigned char* dst = &data[(size_t)y * tw * 4];
+        for (int x = 0; x < tw; x++) {
+            dst[x * 4 + 0] = (src[x] >> 16) & 0xFF;
+            dst[x * 4 + 1] = (src[x] >> 8) & 0xFF;
+            dst[x * 4 + 2] = src[x] & 0xFF;
+            dst[x * 4 + 3] = src[x] >> 24;
+        }
+    }
+    free(pixels);
+    free(canvas);
+
+    GE_InitSpriteFull(sprite, tw, th, data, true);
+    sprite->premultiplied = true;
+    GE_DetectOpaque(sprite);
+    obj->sprite = sprite;
+    obj->off_x = x0 + tx0;
+    obj->off_y = y0 + ty0;
+}
 
-    if (align == 1) { // GE_ALIGN_CENTER
-        finalX = x - (size.x / 2.0f);
-    } 
-    else if (align == 2) { // GE_ALIGN_RIGHT
-        finalX = x - size.x;
+void GE_DrawTextObject(GE_Context* ctx, GE_TextObject* obj, float x, float y) {
+    if (!ctx || !ctx->render_buffer || !obj) return;
+    if (obj->retired_count > 0 && !(ctx->deferred && ctx->deferred->recording)) GE_FreeRetiredTextSprites(obj);
+    if (obj->dirty || GE_ReadyFont(obj->font) != obj->drawn_font) GE_RenderTextObject(ctx, obj);
+    if (!obj->sprite) return;
+
+    int w = obj->sprite->width, h = obj->sprite->height;
+    int dx = (int)floorf(x + 0.5f) + obj->off_x;
+    int dy = (int)floorf(y + 0.5f) + obj->off_y;
+    GE_Tint t = GE_MakeTint(0xFFFFFFFF);
+    GE_BlitSpriteRegion(ctx, obj->sprite, 0, 0, w, h, dx, dy, w, h, GE_FLIP_NONE, &t);
+}
+
+void GE_UnloadTextObject(GE_TextObject* obj) {
+    if (obj) {
+        GE_FreeRetiredTextSprites(obj);
+        free(obj->retired);
+        GE_UnloadSprite(obj->sprite);
+        free(obj->text);
+        free(obj);
     }
-    
-    GE_DrawText(c, f, t, finalX, y, col);
 }
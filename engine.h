@@ -10,6 +10,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 // ============================================================================
 // 1. TIPOS Y ESTRUCTURAS DE DATOS
@@ -26,7 +27,13 @@ typedef struct { float x, y, w, h; } GE_Rect;
 typedef struct GE_Context GE_Context;
 typedef struct GE_Sprite GE_Sprite;
 typedef struct GE_Font GE_Font;
+typedef struct GE_FontFace GE_FontFace;
+typedef struct GE_TextObject GE_TextObject;
 typedef struct GE_Sound GE_Sound;
+typedef struct GE_Atlas GE_Atlas;
+typedef struct GE_SpriteSheet GE_SpriteSheet;
+typedef struct GE_Tilemap GE_Tilemap;
+typedef struct GE_Layer GE_Layer;
 
 // Cámara 2D
 typedef struct {
@@ -36,9 +43,55 @@ typedef struct {
     float zoom;      // 1.0f es normal, 2.0f es zoom x2
 } GE_Camera;
 
+// Instancia para dibujado por lotes (GE_DrawSpriteBatch)
+typedef struct {
+    GE_Rect src;    // Región del sprite (w/h = 0 -> sprite completo)
+    GE_Rect dest;   // Posición en pantalla (w/h = 0 -> mismo tamaño que src)
+    GE_Color tint;
+} GE_SpriteInstance;
+
+// Espejo al dibujar (se pueden combinar: GE_FLIP_X | GE_FLIP_Y)
+typedef enum {
+    GE_FLIP_NONE = 0,
+    GE_FLIP_X = 1,
+    GE_FLIP_Y = 2
+} GE_Flip;
+
+// Modo de mezcla (afecta a primitivas, sprites y texto)
+typedef enum {
+    GE_BLEND_ALPHA = 0,     // Transparencia normal (por defecto)
+    GE_BLEND_ADDITIVE,      // Suma: brillos, fuego, partículas
+    GE_BLEND_MULTIPLY,      // Multiplica: sombras, oscurecer
+    GE_BLEND_SCREEN,        // Pantalla: aclara sin quemar
+    GE_BLEND_REPLACE        // Copia directa (sin mezcla)
+} GE_BlendMode;
+
+// Filtro de muestreo de sprites escalados / rotados
+typedef enum {
+    GE_FILTER_NEAREST = 0,  // Píxel más cercano (pixel art, por defecto)
+    GE_FILTER_BILINEAR      // Interpolación de 4 texels (escalado suave)
+} GE_TextureFilter;
+
+// Estadísticas de la caché de sprites transformados
+typedef struct {
+    uint64_t hits, misses, evictions;
+    size_t bytes_used, budget;
+    int entry_count;
+} GE_TransformCacheStats;
+
+// Estadísticas de la última pasada diferida de sprites
+typedef struct {
+    int commands;            // Dibujos grabados
+    int opaque_commands;     // Cuántos se trataron como opacos (oclusores)
+    uint64_t pixels_drawn;   // Píxeles escritos (sobredibujado = pixels_drawn / área de pantalla)
+    uint64_t pixels_occluded; // Píxeles que no se escribieron por estar tapados
+} GE_DeferredStats;
+
 // Sistema de Animación
 typedef struct {
     GE_Sprite* sprite;
+    GE_SpriteSheet* sheet;  // Opcional: tabla de cuadros precalculada
+    int columns;            // Columnas de la rejilla (si no hay hoja)
     int frame_w, frame_h;   // Tamaño de cada cuadro
     int start_frame;        // Cuadro inicial
     int end_frame;          // Cuadro final
@@ -49,6 +102,12 @@ typedef struct {
     bool loop;              // Si true, vuelve al inicio
 } GE_Animation;
 
+// Modo de mapeo de textura para GE_DrawSpriteQuadEx
+typedef enum {
+    GE_QUAD_AFFINE = 0,     // Afín por triángulo (rápido, costura visible en la diagonal)
+    GE_QUAD_PERSPECTIVE     // Corrección de perspectiva (suelos pseudo-3D)
+} GE_QuadMode;
+
 // Alineación de texto
 typedef enum {
     GE_ALIGN_LEFT = 0, 
@@ -56,6 +115,16 @@ typedef enum {
     GE_ALIGN_RIGHT
 } GE_TextAlign;
 
+// Estilo de texto SDF (GE_DrawTextSDF). Los efectos llegan hasta 8 texels del tamaño base
+// fuera del borde del glifo (escalados al tamaño de dibujo).
+typedef struct {
+    float smoothing;         // Ancho del borde suavizado en píxeles (0 = 1 píxel)
+    float outline;           // Grosor del contorno en píxeles (0 = sin contorno)
+    GE_Color outline_color;
+    float glow;              // Alcance del resplandor fuera del borde en píxeles (0 = sin resplandor)
+    GE_Color glow_color;
+} GE_TextStyle;
+
 // Teclas (Mapeo estandarizado)
 // ============================================================================
 // REEMPLAZAR EN ENGINE.H (CORRECCIÓN ASCII)
@@ -115,6 +184,15 @@ void GE_Close(GE_Context* ctx);
 // Limpia la pantalla con un color base.
 void GE_Clear(GE_Context* ctx, GE_Color color);
 
+// Render multihilo (opcional; por defecto todo se dibuja al momento en un solo hilo).
+// Con 'thread_count' > 1 (p. ej. el número de núcleos) primitivas, GE_Clear y sprites
+// alineados a ejes se graban y se rasterizan en paralelo por tiles de 64x64 en
+// GE_PollEvents, con el mismo resultado. Quads, rotaciones y tilemaps vacían la cola y
+// se dibujan al momento. Sprites y paletas usados deben seguir vivos y sin cambios hasta
+// GE_FlushRendering (o GE_PollEvents). 0 o 1 vuelve al modo inmediato.
+void GE_EnableThreadedRendering(GE_Context* ctx, int thread_count);
+void GE_FlushRendering(GE_Context* ctx); // Espera a que todo lo grabado esté en el buffer
+
 // Control de Tiempo
 void GE_SetTargetFPS(GE_Context* ctx, int fps);
 int GE_GetFPS(GE_Context* ctx);
@@ -135,6 +213,11 @@ int GE_GetMouseWheel(GE_Context* ctx);
 // 4. PRIMITIVAS Y FORMAS BÁSICAS
 // ============================================================================
 
+// Modo de mezcla activo: se aplica a todo lo que se dibuje después (primitivas, sprites, texto).
+// Para un solo dibujo: guardar con GE_GetBlendMode, cambiar, dibujar y restaurar.
+void GE_SetBlendMode(GE_Context* ctx, GE_BlendMode mode);
+GE_BlendMode GE_GetBlendMode(GE_Context* ctx);
+
 void GE_DrawPixel(GE_Context* ctx, float x, float y, GE_Color color);
 
 // Líneas
@@ -181,27 +264,181 @@ void GE_UnloadSprite(GE_Sprite* sprite);
 int GE_GetSpriteWidth(GE_Sprite* sprite);
 int GE_GetSpriteHeight(GE_Sprite* sprite);
 
+// Sprites indexados (8 bpp): un byte por texel más una paleta de hasta 256 colores.
+// GE_LoadSpriteIndexed conserva los colores si la imagen tiene 256 o menos; si no, cuantiza.
+// Cambiar la paleta recolorea al instante todos los dibujos siguientes (cuesta O(colores)).
+// Los sub-sprites comparten la paleta del padre hasta que se les asigna una propia.
+GE_Sprite* GE_LoadSpriteIndexed(const char* filepath);
+GE_Sprite* GE_CreateSpriteIndexed(int width, int height, const unsigned char* indices, const GE_Color* palette, int color_count);
+bool GE_SetSpritePalette(GE_Sprite* sprite, int first, const GE_Color* colors, int count);
+int GE_GetSpritePalette(GE_Sprite* sprite, GE_Color* out, int max_colors); // Retorna las entradas en uso
+
+// Colisión píxel a píxel con máscaras de 1 bit (64 píxeles por palabra).
+// GE_BuildSpriteMask la genera ya (p. ej. al cargar) con el umbral de alpha indicado;
+// si no existe, GE_SpriteOverlap la crea en la primera consulta con umbral 1.
+// La máscara es una foto del alpha: regenerarla si cambian los píxeles o la paleta.
+bool GE_BuildSpriteMask(GE_Sprite* sprite, unsigned char alpha_threshold);
+bool GE_SpriteOverlap(GE_Sprite* a, GE_Point pos_a, GE_Sprite* b, GE_Point pos_b); // Posiciones en píxeles
+
+// Convierte el sprite a alpha premultiplicado (blitter más barato). No aplica a sub-sprites;
+// las vistas ya creadas sobre el sprite siguen su formato.
+bool GE_PremultiplySprite(GE_Sprite* sprite);
+
+// Mipmaps (opcional): con 'build_now' se generan ya; si no, en el primer dibujo reducido.
+// GE_DrawSpriteEx elige el nivel más cercano a la escala y lee mucha menos memoria.
+bool GE_EnableSpriteMipmaps(GE_Sprite* sprite, bool build_now);
+
+// Filtro activo para los dibujos siguientes (escalados, rotados y quads).
+// Como el modo de mezcla: para un solo dibujo, guardar, cambiar y restaurar.
+void GE_SetTextureFilter(GE_Context* ctx, GE_TextureFilter filter);
+GE_TextureFilter GE_GetTextureFilter(GE_Context* ctx);
+
 // Dibujado
 void GE_DrawSprite(GE_Context* ctx, GE_Sprite* sprite, float x, float y, GE_Color tint);
 void GE_DrawSpriteEx(GE_Context* ctx, GE_Sprite* sprite, GE_Rect src, GE_Rect dest, GE_Color tint);
+void GE_DrawSpriteFlipped(GE_Context* ctx, GE_Sprite* sprite, GE_Rect src, GE_Rect dest, int flip, GE_Color tint); // flip: GE_Flip
 void GE_DrawSpritePro(GE_Context* ctx, GE_Sprite* sprite, GE_Rect src, GE_Rect dest, GE_Point origin, float rotation, GE_Color tint);
+
+// Caché de sprites pretransformados (opcional). Guarda la versión ya rotada/escalada por
+// (sprite, región, ángulo cuantizado, escala cuantizada) y la copia 1:1 en los siguientes
+// dibujos. Presupuesto en bytes; 0 la desactiva y libera. Sin caché, GE_DrawSpriteCached
+// equivale a GE_DrawSpritePro. 'origin' es el pivote (en píxeles escalados) que cae en 'position'.
+void GE_EnableTransformCache(GE_Context* ctx, size_t budget_bytes);
+void GE_ClearTransformCache(GE_Context* ctx); // Llamar si se modifican los píxeles de un sprite cacheado
+GE_TransformCacheStats GE_GetTransformCacheStats(GE_Context* ctx);
+void GE_DrawSpriteCached(GE_Context* ctx, GE_Sprite* sprite, GE_Rect src, GE_Point position, GE_Point origin,
+                         float rotation, float scale, GE_Color tint);
+
+// Pasada diferida (opcional): entre Begin y End los sprites alineados a ejes se graban y,
+// al cerrar, los opacos se pintan de delante hacia atrás saltando lo ya cubierto y el
+// resto encima en orden. Mismo resultado, menos sobredibujado. Los sprites grabados deben
+// seguir vivos hasta GE_EndDeferredSprites; lo que no es sprite se dibuja al momento.
+void GE_BeginDeferredSprites(GE_Context* ctx);
+void GE_EndDeferredSprites(GE_Context* ctx);
+GE_DeferredStats GE_GetDeferredStats(GE_Context* ctx);
+
+// Lotes: miles de instancias del mismo sprite con una sola validación y culling en bloque,
+// dibujadas en el orden de envío. La variante Sorted agrupa por región fuente (mejor uso
+// de caché) y solo respeta el orden dentro de cada región: úsala si no se solapan.
+void GE_DrawSpriteBatch(GE_Context* ctx, GE_Sprite* sprite, const GE_SpriteInstance* instances, int count);
+void GE_DrawSpriteBatchSorted(GE_Context* ctx, GE_Sprite* sprite, const GE_SpriteInstance* instances, int count);
+
+// Deformación libre (Quad warping). Esquinas en orden: p1 = arriba-izq, p2 = arriba-der,
+// p3 = abajo-der, p4 = abajo-izq. GE_DrawSpriteQuad usa corrección de perspectiva.
 void GE_DrawSpriteQuad(GE_Context* ctx, GE_Sprite* sprite, GE_Point p1, GE_Point p2, GE_Point p3, GE_Point p4, GE_Color tint);
+void GE_DrawSpriteQuadEx(GE_Context* ctx, GE_Sprite* sprite, GE_Rect src, const GE_Point quad[4], GE_QuadMode mode, GE_Color tint);
+
+// Atlas de texturas: empaqueta muchas imágenes pequeñas en páginas grandes.
+// Los sprites devueltos son vistas dentro de una página (sin bordes transparentes)
+// y pertenecen al atlas: se liberan con GE_UnloadAtlas (GE_UnloadSprite los ignora).
+GE_Atlas* GE_CreateAtlas(int page_width, int page_height);
+GE_Sprite* GE_AtlasAddImage(GE_Atlas* atlas, const char* filepath);
+GE_Sprite* GE_AtlasAddPixels(GE_Atlas* atlas, const unsigned char* rgba, int width, int height); // RGBA8
+int GE_GetAtlasPageCount(GE_Atlas* atlas);
+void GE_UnloadAtlas(GE_Atlas* atlas);
+
+// Sub-sprites: vistas sin copia sobre una región del padre (el padre debe seguir vivo).
+// Se liberan con GE_UnloadSprite, que no toca los píxeles compartidos.
+GE_Sprite* GE_CreateSubSprite(GE_Sprite* parent, GE_Rect region);
+
+// Hojas de sprites: tabla de cuadros precalculada (rejilla o rects empaquetados)
+GE_SpriteSheet* GE_CreateSpriteSheetGrid(GE_Sprite* sprite, int frame_w, int frame_h, int margin, int spacing);
+GE_SpriteSheet* GE_CreateSpriteSheetRects(GE_Sprite* sprite, const GE_Rect* frames, int count);
+void GE_UnloadSpriteSheet(GE_SpriteSheet* sheet);
+int GE_GetSpriteSheetFrameCount(GE_SpriteSheet* sheet);
+GE_Rect GE_GetSpriteSheetFrame(GE_SpriteSheet* sheet, int frame);
+void GE_DrawSpriteSheetFrame(GE_Context* ctx, GE_SpriteSheet* sheet, int frame, float x, float y, int flip, GE_Color tint);
 
 // Animaciones
 GE_Animation GE_CreateAnimation(GE_Sprite* sprite, int fw, int fh, float duration);
+// Cuadros [start_frame, end_frame] recortados a la hoja; un rango vacío da una animación inactiva
+GE_Animation GE_CreateAnimationFromSheet(GE_SpriteSheet* sheet, int start_frame, int end_frame, float duration);
 void GE_UpdateAnimation(GE_Animation* anim, float dt);
 void GE_DrawAnimation(GE_Context* ctx, GE_Animation* anim, float x, float y, bool flip_x, GE_Color tint);
 
+// Tilemaps: rejilla de índices (cuadros de 'tileset'; -1 = vacío). Se dibuja sin escalar
+// con la esquina superior izquierda en (x, y); para seguir una cámara, x = -scroll_x.
+// Los bloques de ~256x256 px se componen una vez y se reutilizan hasta que cambia un tile.
+// GE_InvalidateTilemap los recompone si cambian los píxeles o la paleta del tileset.
+GE_Tilemap* GE_CreateTilemap(GE_SpriteSheet* tileset, int columns, int rows, int tile_w, int tile_h);
+void GE_UnloadTilemap(GE_Tilemap* map);
+void GE_SetTile(GE_Tilemap* map, int col, int row, int tile);
+int GE_GetTile(GE_Tilemap* map, int col, int row); // -1 si está vacío o fuera del mapa
+void GE_SetTilemapData(GE_Tilemap* map, const int* tiles); // columns * rows índices, por filas
+void GE_InvalidateTilemap(GE_Tilemap* map);
+void GE_SetTilemapCacheBudget(GE_Tilemap* map, size_t budget_bytes); // Por defecto 16 MB
+void GE_DrawTilemap(GE_Context* ctx, GE_Tilemap* map, float x, float y);
+
+// Capas: cada una tiene su propio buffer (del tamaño de la resolución interna) que se
+// conserva entre frames. Entre GE_BeginLayer y GE_EndLayer todo lo dibujado va a la capa;
+// GE_BeginLayer retorna false si la capa está limpia (no hace falta redibujarla) y, si
+// está sucia, la vacía (las opacas conservan lo anterior). GE_PollEvents compone las capas
+// visibles encima del lienzo por orden de 'z' (menor = más al fondo) en una sola pasada:
+// la opaca más alta se copia y tapa todo lo de debajo. En las capas transparentes lo que
+// se dibuja en modo ALPHA conserva su cobertura; para brillos, dibujar con ADDITIVE en una
+// capa compuesta en modo ADDITIVE. Se liberan con GE_UnloadLayer (también tras GE_Close).
+GE_Layer* GE_CreateLayer(GE_Context* ctx, int z, bool opaque);
+void GE_UnloadLayer(GE_Layer* layer);
+bool GE_BeginLayer(GE_Context* ctx, GE_Layer* layer);
+void GE_EndLayer(GE_Context* ctx);
+void GE_MarkLayerDirty(GE_Layer* layer); // Redibujar en el próximo GE_BeginLayer
+bool GE_IsLayerDirty(GE_Layer* layer);
+void GE_SetLayerVisible(GE_Layer* layer, bool visible);
+void GE_SetLayerBlendMode(GE_Layer* layer, GE_BlendMode mode); // GE_BLEND_ALPHA (por defecto) o GE_BLEND_ADDITIVE
+void GE_SetLayerScroll(GE_Layer* layer, float x, float y);     // Desplaza al componer, con repetición (parallax sin redibujar)
+void GE_ComposeLayers(GE_Context* ctx); // Opcional: para leer el frame compuesto antes de GE_PollEvents
+
 // ============================================================================
 // 7. TEXTO (FONTS)
 // ============================================================================
 
+// Texto en UTF-8. Los glifos se rasterizan la primera vez que se usan y se guardan en
+// páginas de atlas A8; si superan el presupuesto (1 MB por defecto) se reciclan las menos usadas.
 GE_Font* GE_LoadFont(const char* filepath, float size);
 void GE_UnloadFont(GE_Font* font);
+void GE_SetFontCacheBudget(GE_Font* font, size_t budget_bytes);
+
+// Carga en un hilo aparte (abrir la cara y rasterizar el ASCII): vuelve al momento.
+// Hasta que GE_IsFontReady sea true se mide y dibuja con 'fallback' (NULL = nada).
+// Si la carga falla nunca llega a estar lista. Se libera con GE_UnloadFont.
+// GE_SetFontCacheBudget sobre una fuente que aún carga espera a que termine.
+GE_Font* GE_LoadFontAsync(const char* filepath, float size, GE_Font* fallback);
+bool GE_IsFontReady(GE_Font* font);
+
+// Una cara (archivo TTF) se mapea en memoria una sola vez y la comparten todos sus tamaños.
+// GE_LoadFont usa la misma cara si la ruta ya está abierta. Cada fuente guarda su propia
+// referencia: la cara puede liberarse en cuanto se crean los tamaños.
+GE_FontFace* GE_LoadFontFace(const char* filepath);
+GE_Font* GE_CreateFont(GE_FontFace* face, float size);
+void GE_UnloadFontFace(GE_FontFace* face);
+
+// Fuente bitmap ya rasterizada (BMFont .fnt en texto, XML o binario; páginas junto al .fnt).
+// Sin coste de rasterizado; se dibuja y mide con las mismas funciones (se libera con GE_UnloadFont).
+GE_Font* GE_LoadBitmapFont(const char* filepath);
 
 void GE_DrawText(GE_Context* ctx, GE_Font* font, const char* text, float x, float y, GE_Color color);
 void GE_DrawTextAligned(GE_Context* ctx, GE_Font* font, const char* text, float x, float y, GE_TextAlign align, GE_Color color);
-GE_Point GE_MeasureText(GE_Font* font, const char* text);
+GE_Point GE_MeasureText(GE_Font* font, const char* text); // Ancho de la línea más larga x alto real
+
+// Los saltos '\n' empiezan otra línea ('y' es la línea base de la primera) y en las
+// funciones alineadas cada línea se alinea por separado. La caja ajusta palabras al
+// ancho de 'rect' si 'wrap' es true; la maquetación queda en caché entre frames.
+void GE_DrawTextBox(GE_Context* ctx, GE_Font* font, const char* text, GE_Rect rect, GE_TextAlign align, bool wrap, GE_Color color);
+
+// Fuente SDF: un solo atlas de campos de distancias (generado a 'base_size') sirve para
+// todos los tamaños sin perder nitidez. Con las funciones normales se dibuja a 'base_size';
+// GE_DrawTextSDF dibuja a 'size' con estilo opcional (NULL = solo relleno). Las medidas
+// de GE_MeasureText son a 'base_size' y escalan linealmente.
+GE_Font* GE_CreateFontSDF(GE_FontFace* face, float base_size);
+void GE_DrawTextSDF(GE_Context* ctx, GE_Font* font, const char* text, float x, float y, float size, GE_Color color, const GE_TextStyle* style);
+
+// Texto estático (etiquetas, ayudas): se genera una vez como sprite y se dibuja con un
+// solo blit. Solo se regenera si cambian el texto o el color. 'y' es la línea base.
+GE_TextObject* GE_CreateTextObject(GE_Font* font, const char* text, GE_Color color);
+void GE_SetTextObjectText(GE_TextObject* obj, const char* text);
+void GE_SetTextObjectColor(GE_TextObject* obj, GE_Color color);
+void GE_DrawTextObject(GE_Context* ctx, GE_TextObject* obj, float x, float y);
+void GE_UnloadTextObject(GE_TextObject* obj);
 
 // ============================================================================
 // 8. AUDIO